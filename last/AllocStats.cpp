@@ -0,0 +1,150 @@
+#include "AllocStats.hpp"
+#ifdef SHMUP_ALLOC_STATS
+#include "Constants.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Every block carries its size in a header, so frees can be counted in
+// bytes too. The counters are constant-initialized atomics: they work before
+// main() and from the job system's worker threads.
+static const size_t header = alignof(std::max_align_t);
+
+struct PhaseCounters {
+    std::atomic<long> allocs;
+    std::atomic<long> frees;
+    std::atomic<long> bytes;
+    std::atomic<long> steady;           // allocations from steady_from() on
+};
+
+static const char* const phase_names[ALLOC_PHASE_COUNT] = {"other", "input", "update", "collide", "render"};
+static const char* const pool_names[ALLOC_POOL_COUNT] = {"bullets", "enemies", "bosses"};
+
+static PhaseCounters counters[ALLOC_PHASE_COUNT];
+static std::atomic<unsigned char> phase(ALLOC_OTHER);
+static std::atomic<long> live_bytes(0);
+static std::atomic<long> peak_bytes(0);
+static std::atomic<long> current_tick(-1);
+static std::atomic<long> tick_allocs(0);
+static std::atomic<long> tick_bytes(0);
+static long worst_allocs = 0, worst_bytes = 0, worst_tick = -1;
+static long steady_tick = (REWIND_SECONDS + 2) * FPS;   // the rewind ring has wrapped by then
+static bool strict_mode = false;
+static std::atomic<long> steady_total(0);
+static long first_tick = -1, first_size = 0;
+static AllocPhase first_phase = ALLOC_OTHER;
+static size_t pool_peak[ALLOC_POOL_COUNT], pool_capacity[ALLOC_POOL_COUNT];
+
+static void counted(void* p, size_t size) {
+    *static_cast<size_t*>(p) = size;
+    unsigned char ph = phase.load(std::memory_order_relaxed);
+    counters[ph].allocs.fetch_add(1, std::memory_order_relaxed);
+    counters[ph].bytes.fetch_add(long(size), std::memory_order_relaxed);
+    tick_allocs.fetch_add(1, std::memory_order_relaxed);
+    tick_bytes.fetch_add(long(size), std::memory_order_relaxed);
+    long live = live_bytes.fetch_add(long(size), std::memory_order_relaxed) + long(size);
+    for (long peak = peak_bytes.load(std::memory_order_relaxed);
+        live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed);) {}
+    long t = current_tick.load(std::memory_order_relaxed);
+    if (t < steady_tick) return;
+    counters[ph].steady.fetch_add(1, std::memory_order_relaxed);
+    if (steady_total.fetch_add(1, std::memory_order_relaxed) == 0) {
+        first_tick = t;
+        first_size = long(size);
+        first_phase = AllocPhase(ph);
+    }
+}
+
+static void released(void* p) {
+    unsigned char ph = phase.load(std::memory_order_relaxed);
+    counters[ph].frees.fetch_add(1, std::memory_order_relaxed);
+    live_bytes.fetch_sub(long(*static_cast<size_t*>(p)), std::memory_order_relaxed);
+}
+
+static void* allocate(size_t size, size_t align) {
+    size_t head = align > header ? align : header;
+    void* p = align > header ? aligned_alloc(align, (size + head + align - 1) / align * align) : malloc(size + head);
+    if (!p) return nullptr;
+    // The size sits right before the user block, wherever the header ends.
+    void* user = static_cast<char*>(p) + head;
+    counted(static_cast<char*>(user) - sizeof(size_t), size);
+    return user;
+}
+
+static void deallocate(void* user, size_t align) {
+    if (!user) return;
+    size_t head = align > header ? align : header;
+    released(static_cast<char*>(user) - sizeof(size_t));
+    free(static_cast<char*>(user) - head);
+}
+
+void* operator new(size_t size) {
+    if (void* p = allocate(size, header)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size, header); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size, header); }
+void* operator new(size_t size, std::align_val_t align) {
+    if (void* p = allocate(size, size_t(align))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t align) { return operator new(size, align); }
+void operator delete(void* p) noexcept { deallocate(p, header); }
+void operator delete[](void* p) noexcept { deallocate(p, header); }
+void operator delete(void* p, size_t) noexcept { deallocate(p, header); }
+void operator delete[](void* p, size_t) noexcept { deallocate(p, header); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { deallocate(p, header); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { deallocate(p, header); }
+void operator delete(void* p, std::align_val_t align) noexcept { deallocate(p, size_t(align)); }
+void operator delete[](void* p, std::align_val_t align) noexcept { deallocate(p, size_t(align)); }
+void operator delete(void* p, size_t, std::align_val_t align) noexcept { deallocate(p, size_t(align)); }
+void operator delete[](void* p, size_t, std::align_val_t align) noexcept { deallocate(p, size_t(align)); }
+
+    AllocPhase AllocStats::enter(AllocPhase next) {
+        return AllocPhase(phase.exchange(next, std::memory_order_relaxed));
+    }
+    // Closes the previous tick's totals and starts counting the next one.
+    void AllocStats::tick(long t) {
+        long allocs = tick_allocs.exchange(0, std::memory_order_relaxed);
+        long bytes = tick_bytes.exchange(0, std::memory_order_relaxed);
+        long previous = current_tick.exchange(t, std::memory_order_relaxed);
+        if (previous >= 0 && (allocs > worst_allocs || (allocs == worst_allocs && bytes > worst_bytes))) {
+            worst_allocs = allocs;
+            worst_bytes = bytes;
+            worst_tick = previous;
+        }
+    }
+    void AllocStats::pool(AllocPool p, size_t size, size_t capacity) {
+        if (size > pool_peak[p]) pool_peak[p] = size;
+        pool_capacity[p] = capacity;
+    }
+    void AllocStats::strict(long from_tick) {
+        strict_mode = true;
+        steady_tick = from_tick;
+    }
+    long AllocStats::steady_from() { return steady_tick; }
+    long AllocStats::allocations() {
+        long n = 0;
+        for (const PhaseCounters& c : counters) n += c.allocs.load(std::memory_order_relaxed);
+        return n;
+    }
+    long AllocStats::steady_allocations() { return steady_total.load(std::memory_order_relaxed); }
+    bool AllocStats::failed() { return strict_mode && steady_allocations() > 0; }
+
+    void AllocStats::report(FILE* out) {
+        fprintf(out, "alloc: %-8s %10s %10s %12s %8s\n", "phase", "allocs", "frees", "bytes", "steady");
+        for (int p = 0; p < ALLOC_PHASE_COUNT; p++)
+            fprintf(out, "alloc: %-8s %10ld %10ld %12ld %8ld\n", phase_names[p], counters[p].allocs.load(),
+                counters[p].frees.load(), counters[p].bytes.load(), counters[p].steady.load());
+        fprintf(out, "alloc: live %ld B, peak %ld B; worst tick %ld: %ld allocs, %ld B\n", live_bytes.load(),
+            peak_bytes.load(), worst_tick, worst_allocs, worst_bytes);
+        for (int p = 0; p < ALLOC_POOL_COUNT; p++)
+            fprintf(out, "alloc: %-8s peak %zu of %zu slots\n", pool_names[p], pool_peak[p], pool_capacity[p]);
+        long steady = steady_allocations();
+        fprintf(out, "alloc: %ld allocations from tick %ld on", steady, steady_tick);
+        if (steady)
+            fprintf(out, ", first at tick %ld in %s (%ld B)", first_tick, phase_names[first_phase], first_size);
+        fprintf(out, "%s\n", failed() ? " -- FAILED" : "");
+    }
+#endif
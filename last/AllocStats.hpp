@@ -0,0 +1,61 @@
+#pragma once
+
+// Counting global allocator, built only with -DSHMUP_ALLOC_STATS (make
+// allocstats). The replaced operator new/delete attribute every allocation to
+// the game phase running at the time; otherwise every ALLOC_* macro expands to
+// nothing and the standard allocator is used.
+#ifdef SHMUP_ALLOC_STATS
+#include <cstddef>
+#include <cstdio>
+
+enum AllocPhase : unsigned char {
+    ALLOC_OTHER,                        // startup, snapshots, terminal, anything between phases
+    ALLOC_INPUT,
+    ALLOC_UPDATE,
+    ALLOC_COLLIDE,
+    ALLOC_RENDER,
+    ALLOC_PHASE_COUNT
+};
+
+enum AllocPool : unsigned char {
+    ALLOC_BULLETS,
+    ALLOC_ENEMIES,
+    ALLOC_BOSSES,
+    ALLOC_POOL_COUNT
+};
+
+// All state is global, like the allocator it counts. Allocations made from
+// tick steady_from() on are the steady-state loop's; in strict mode any of
+// them fails the run.
+class AllocStats {
+public:
+    static AllocPhase enter(AllocPhase phase);
+    static void tick(long tick);
+    static void pool(AllocPool pool, size_t size, size_t capacity);
+    static void strict(long from_tick);
+    static long steady_from();
+    static long allocations();
+    static long steady_allocations();
+    static bool failed();
+    static void report(FILE* out);
+};
+
+class AllocScope {
+    AllocPhase previous;
+public:
+    explicit AllocScope(AllocPhase phase) : previous(AllocStats::enter(phase)) {}
+    ~AllocScope() { AllocStats::enter(previous); }
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+};
+
+#define ALLOC_JOIN2(a, b) a##b
+#define ALLOC_JOIN(a, b) ALLOC_JOIN2(a, b)
+#define ALLOC_PHASE(phase) AllocScope ALLOC_JOIN(alloc_scope_, __LINE__)(phase)
+#define ALLOC_TICK(t) AllocStats::tick(t)
+#define ALLOC_POOL(p, store) AllocStats::pool(p, (store).size(), (store).capacity())
+#else
+#define ALLOC_PHASE(phase) ((void)0)
+#define ALLOC_TICK(t) ((void)0)
+#define ALLOC_POOL(p, store) ((void)0)
+#endif
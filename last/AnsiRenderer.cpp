@@ -0,0 +1,228 @@
+#include "AnsiRenderer.hpp"
+#include "Constants.hpp"
+#include <ncursesw/ncurses.h>
+#include <cstdio>
+#include <cerrno>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+// Same looks as NcursesRenderer's colour pairs. Every code starts with a
+// reset so switching never depends on what was selected before.
+static const char* const sgr_codes[PAL_COUNT] = {
+    "\x1b[0m", "\x1b[0;2m", "\x1b[0;1;36m", "\x1b[0;33m",
+    "\x1b[0;31m", "\x1b[0;32m", "\x1b[0;35m", "\x1b[0;1;31m", "\x1b[0;1;34m"};
+
+static const char done_seq[] = "\x1b[0m\x1b[?25h\x1b[?1049l";
+static const int fatal_signals[3] = {SIGINT, SIGTERM, SIGHUP};
+
+static volatile sig_atomic_t resized = 0;
+static struct termios restore_tty;
+static volatile sig_atomic_t restore_raw = 0;
+
+static void on_winch(int) { resized = 1; }
+
+// ISIG stays on so ^C still interrupts; the handler puts the terminal back
+// the way the destructor would, using only async-signal-safe calls, then
+// dies of the same signal.
+static void on_fatal(int sig) {
+    if (write(STDOUT_FILENO, done_seq, sizeof(done_seq) - 1) < 0) {}
+    if (restore_raw) tcsetattr(STDIN_FILENO, TCSANOW, &restore_tty);
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static int utf8(wchar_t ch, char* out) {
+    uint32_t c = ch;
+    if (c < 0x80) {
+        out[0] = c;
+        return 1;
+    } else if (c < 0x800) {
+        out[0] = 0xc0 | (c >> 6);
+        out[1] = 0x80 | (c & 0x3f);
+        return 2;
+    } else if (c < 0x10000) {
+        out[0] = 0xe0 | (c >> 12);
+        out[1] = 0x80 | ((c >> 6) & 0x3f);
+        out[2] = 0x80 | (c & 0x3f);
+        return 3;
+    }
+    out[0] = 0xf0 | (c >> 18);
+    out[1] = 0x80 | ((c >> 12) & 0x3f);
+    out[2] = 0x80 | ((c >> 6) & 0x3f);
+    out[3] = 0x80 | (c & 0x3f);
+    return 4;
+}
+
+    AnsiRenderer::AnsiRenderer() : used(0), cur_x(-1), cur_y(-1), sgr(-1), last_w(-1), last_h(-1),
+        raw(false), pending_len(0) {
+        const Atlas& atlas = Atlas::shared();
+        glyphs.resize(atlas.size());
+        for (size_t i = 0; i < atlas.size(); i++) {
+            const Glyph& g = atlas.glyph(i);
+            glyphs[i].length = g.ch ? utf8(g.ch, glyphs[i].bytes) : 0;
+            glyphs[i].width = g.width;
+            glyphs[i].color = g.color;
+        }
+        if (tcgetattr(STDIN_FILENO, &saved) == 0) {
+            struct termios t = saved;
+            t.c_lflag &= ~(ICANON | ECHO);
+            t.c_cc[VMIN] = 0;
+            t.c_cc[VTIME] = 0;
+            raw = tcsetattr(STDIN_FILENO, TCSANOW, &t) == 0;
+            restore_tty = saved;
+            restore_raw = raw;
+        }
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = on_winch;
+        sigaction(SIGWINCH, &sa, &saved_winch);
+        sa.sa_handler = on_fatal;
+        for (int i = 0; i < 3; i++) sigaction(fatal_signals[i], &sa, &saved_fatal[i]);
+        int w, h;
+        viewport(w, h);
+        frame.resize(size_t(w) * h * 24 + 256);
+        static const char init[] = "\x1b[?1049h\x1b[?25l\x1b[0m\x1b[2J";
+        emit(init, sizeof(init) - 1);
+        flush();
+    }
+    AnsiRenderer::~AnsiRenderer() {
+        for (int i = 0; i < 3; i++) sigaction(fatal_signals[i], &saved_fatal[i], nullptr);
+        emit(done_seq, sizeof(done_seq) - 1);
+        flush();
+        if (raw) tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+        restore_raw = 0;
+        sigaction(SIGWINCH, &saved_winch, nullptr);
+    }
+    int AnsiRenderer::fill_input() {
+        ssize_t n = read(STDIN_FILENO, pending + pending_len, sizeof(pending) - pending_len);
+        if (n > 0) pending_len += n;
+        return pending_len;
+    }
+    // Arrow keys arrive as ESC [ A..D (or ESC O A..D in application mode)
+    // and are mapped to the ncurses key codes Player already understands.
+    int AnsiRenderer::read_key() {
+        if (resized) {
+            resized = 0;
+            return KEY_RESIZE;
+        }
+        if (!pending_len && !fill_input()) return KEY_NONE;
+        int key = pending[0], used_bytes = 1;
+        if (key == 0x1b && pending_len < 3) fill_input();
+        if (key == 0x1b && pending_len >= 3 && (pending[1] == '[' || pending[1] == 'O')) {
+            static const int arrows[4] = {KEY_UP, KEY_DOWN, KEY_RIGHT, KEY_LEFT};
+            if (pending[2] >= 'A' && pending[2] <= 'D') key = arrows[pending[2] - 'A'];
+            used_bytes = 3;
+        }
+        pending_len -= used_bytes;
+        memmove(pending, pending + used_bytes, pending_len);
+        return key;
+    }
+    int AnsiRenderer::wait_key(int timeout_ms) {
+        if (!pending_len && !resized) {
+            struct pollfd p = {STDIN_FILENO, POLLIN, 0};
+            poll(&p, 1, timeout_ms);
+        }
+        return read_key();
+    }
+    // Picks the shortest way from the cursor to (x, y): nothing, a repaint
+    // of the few unchanged cells in between, CR LF, a forward jump or an
+    // absolute move.
+    void AnsiRenderer::move_to(const FrameBuffer& fb, int x, int y) {
+        if (cur_x == x && cur_y == y) return;
+        char buf[24];
+        int n;
+        if (cur_y == y && cur_x >= 0 && x > cur_x) {
+            n = snprintf(buf, sizeof(buf), "\x1b[%dC", x - cur_x);
+            int cost = 0;
+            for (int i = cur_x; i < x && cost <= n; i++) {
+                const Encoded& e = glyphs[fb.at(i, y)];
+                cost = e.width == 1 && e.color == sgr ? cost + e.length : n + 1;
+            }
+            if (cost <= n) {
+                for (int i = cur_x; i < x; i++) emit(glyphs[fb.at(i, y)].bytes, glyphs[fb.at(i, y)].length);
+                return;
+            }
+        } else if (x == 0 && cur_y >= 0 && y == cur_y + 1) {
+            n = snprintf(buf, sizeof(buf), "\r\n");
+        } else {
+            n = snprintf(buf, sizeof(buf), "\x1b[%d;%dH", y + 1, x + 1);
+        }
+        emit(buf, n);
+    }
+    void AnsiRenderer::present(FrameBuffer& fb) {
+        const int w = fb.get_width(), h = fb.get_height();
+        if (frame.size() < size_t(w) * h * 24 + 256) frame.resize(size_t(w) * h * 24 + 256);
+        if (w != last_w || h != last_h) {
+            static const char clear[] = "\x1b[0m\x1b[2J";
+            emit(clear, sizeof(clear) - 1);
+            sgr = PAL_DEFAULT;
+            cur_x = cur_y = -1;
+            last_w = w;
+            last_h = h;
+        }
+        long written = 0;
+        for (int y = 0; y < h; y++)
+            for (int x = 0; x < w; x++) {
+                if (!fb.dirty(x, y)) continue;
+                GlyphId g = fb.at(x, y);
+                // A changed tail under an unchanged wide glyph: redraw the glyph.
+                if (g == Atlas::WIDE_TAIL) {
+                    if (x == 0 || fb.dirty(x - 1, y) || fb.at(x - 1, y) == Atlas::WIDE_TAIL) continue;
+                    g = fb.at(--x, y);
+                }
+                const Encoded& e = glyphs[g];
+                move_to(fb, x, y);
+                if (e.color != sgr) {
+                    emit(sgr_codes[e.color], strlen(sgr_codes[e.color]));
+                    sgr = e.color;
+                }
+                emit(e.bytes, e.length);
+                written++;
+                cur_x = x + e.width;
+                cur_y = y;
+                if (cur_x >= w) cur_x = -1;     // pending wrap: position unknown
+                x += e.width - 1;
+            }
+        fb.flip(written);
+        flush();
+    }
+    // One write() per frame unless the terminal takes it in pieces.
+    void AnsiRenderer::flush() {
+        size_t done = 0;
+        while (done < used) {
+            ssize_t n = write(STDOUT_FILENO, frame.data() + done, used - done);
+            counted.writes++;
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            done += n;
+        }
+        counted.bytes += done;
+        used = 0;
+    }
+    void AnsiRenderer::viewport(int& w, int& h) const {
+        struct winsize ws;
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+            w = ws.ws_col;
+            h = ws.ws_row;
+        } else {
+            w = WIDTH;
+            h = HEIGHT;
+        }
+    }
+    void AnsiRenderer::game_over(int score) {
+        int w, h;
+        viewport(w, h);
+        char buf[96];
+        int n = snprintf(buf, sizeof(buf), "\x1b[0m\x1b[2J\x1b[%d;%dHGame Over! Score: %d",
+            h / 2 + 1, std::max(w / 2 - 5, 0) + 1, score);
+        emit(buf, std::min<size_t>(n, sizeof(buf) - 1));
+        flush();
+        last_w = last_h = -1;
+        std::this_thread::sleep_for(std::chrono::seconds(3));
+    }
+    bool AnsiRenderer::realtime() const { return true; }
+    OutputStats AnsiRenderer::output() const { return counted; }
@@ -0,0 +1,51 @@
+#pragma once
+#include "Renderer.hpp"
+#include <vector>
+#include <cstring>
+#include <termios.h>
+#include <signal.h>
+
+// Terminal backend without ncurses: raw termios input and hand-written
+// escape sequences. Each frame's changed cells are encoded into one
+// preallocated buffer, choosing the cheapest cursor move per jump, repainting
+// short unchanged gaps instead of jumping over them and emitting SGR only
+// when the colour changes, then sent with a single write().
+class AnsiRenderer : public Renderer {
+    struct Encoded {
+        char bytes[4];                  // UTF-8
+        unsigned char length;
+        unsigned char width;
+        Palette color;
+    };
+    std::vector<Encoded> glyphs;        // one per atlas glyph, built at startup
+    std::vector<char> frame;
+    size_t used;
+    int cur_x, cur_y;                   // terminal cursor, -1 when unknown
+    int sgr;                            // palette currently selected, -1 when unknown
+    int last_w, last_h;
+    struct termios saved;
+    bool raw;
+    struct sigaction saved_winch;
+    struct sigaction saved_fatal[3];    // SIGINT, SIGTERM, SIGHUP
+    unsigned char pending[16];          // input bytes not yet turned into keys
+    int pending_len;
+    OutputStats counted;
+
+    void emit(const char* p, size_t n) {
+        memcpy(frame.data() + used, p, n);
+        used += n;
+    }
+    void move_to(const FrameBuffer& fb, int x, int y);
+    void flush();
+    int fill_input();
+public:
+    AnsiRenderer();
+    ~AnsiRenderer() override;
+    int read_key() override;
+    int wait_key(int timeout_ms) override;
+    void present(FrameBuffer& fb) override;
+    void viewport(int& w, int& h) const override;
+    void game_over(int score) override;
+    bool realtime() const override;
+    OutputStats output() const override;
+};
@@ -0,0 +1,48 @@
+#include "Atlas.hpp"
+
+// Profiler sparkline levels, interned up front like everything else.
+static const wchar_t bar_glyphs[] = L"▁▂▃▄▅▆▇█";
+
+    Atlas::Atlas() {
+        glyphs.reserve(160);
+        glyphs.push_back(Glyph{0, 0, PAL_DEFAULT});
+        for (wchar_t c = 1; c < 128; c++) glyphs.push_back(Glyph{c >= 32 && c < 127 ? c : L'?', 1, PAL_DEFAULT});
+        for (const wchar_t* b = bar_glyphs; *b; b++) intern(*b, 1, PAL_DEFAULT);
+        add_sprite(SPRITE_PLAYER, 2, 1, L"🦚", PAL_PLAYER);
+        add_sprite(SPRITE_PLAYER_BULLET, 1, 1, L"|", PAL_PLAYER_SHOT);
+        add_sprite(SPRITE_ENEMY_BULLET, 1, 1, L"*", PAL_ENEMY_SHOT);
+        add_sprite(SPRITE_ENEMY, 1, 1, L"E", PAL_ENEMY);
+        add_sprite(SPRITE_SCRIPTED_ENEMY, 1, 1, L"E", PAL_SCRIPTED_ENEMY);
+        add_sprite(SPRITE_BOSS, 1, 2, L"BBBB", PAL_BOSS);
+        add_sprite(SPRITE_DOT, 1, 1, L".", PAL_BACKGROUND);
+        add_sprite(SPRITE_WALL, 1, 1, L"#", PAL_WALL);
+    }
+    const Atlas& Atlas::shared() {
+        static const Atlas atlas;
+        return atlas;
+    }
+    GlyphId Atlas::intern(wchar_t ch, int width, Palette color) {
+        for (size_t i = 128; i < glyphs.size(); i++)
+            if (glyphs[i].ch == ch && glyphs[i].color == color) return i;
+        glyphs.push_back(Glyph{ch, static_cast<unsigned char>(width), color});
+        return glyphs.size() - 1;
+    }
+    // Rows are concatenated; each glyph covers glyph_width columns.
+    void Atlas::add_sprite(SpriteId id, int glyph_width, int height, const wchar_t* rows, Palette color) {
+        int count = wcslen(rows);
+        Sprite& s = sprites[id];
+        s.width = count / height * glyph_width;
+        s.height = height;
+        s.first = cells.size();
+        for (int i = 0; i < count; i++) {
+            cells.push_back(intern(rows[i], glyph_width, color));
+            if (glyph_width == 2) cells.push_back(GlyphId(WIDE_TAIL));
+        }
+    }
+    // Start-up lookup for callers that draw a fixed set of loose glyphs.
+    GlyphId Atlas::find(wchar_t ch, Palette color) const {
+        if (color == PAL_DEFAULT && ch >= 32 && ch < 127) return ch;
+        for (size_t i = 128; i < glyphs.size(); i++)
+            if (glyphs[i].ch == ch && glyphs[i].color == color) return i;
+        return '?';
+    }
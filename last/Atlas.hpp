@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cwchar>
+
+// Index into the atlas' glyph table; this is all a FrameBuffer cell holds.
+// Codes 32..126 are their own ASCII glyphs so text needs no lookup.
+typedef unsigned short GlyphId;
+
+enum Palette : unsigned char {
+    PAL_DEFAULT,
+    PAL_BACKGROUND,
+    PAL_PLAYER,
+    PAL_PLAYER_SHOT,
+    PAL_ENEMY_SHOT,
+    PAL_ENEMY,
+    PAL_SCRIPTED_ENEMY,
+    PAL_BOSS,
+    PAL_WALL,
+    PAL_COUNT
+};
+
+enum SpriteId : unsigned char {
+    SPRITE_PLAYER,
+    SPRITE_PLAYER_BULLET,
+    SPRITE_ENEMY_BULLET,
+    SPRITE_ENEMY,
+    SPRITE_SCRIPTED_ENEMY,
+    SPRITE_BOSS,
+    SPRITE_DOT,
+    SPRITE_WALL,
+    SPRITE_COUNT
+};
+
+struct Glyph {
+    wchar_t ch;
+    unsigned char width;                // terminal columns; a 2 is followed by a WIDE_TAIL cell
+    Palette color;
+};
+
+struct Sprite {
+    unsigned char width, height;
+    unsigned short first;               // row-major cells start here in Atlas::cells
+};
+
+// Every glyph and sprite the game draws, interned once at startup. Wide
+// glyphs and multi-cell sprites are baked into rows of glyph IDs, so
+// drawing is a copy and backends can build their per-glyph output (cchar_t,
+// escape bytes) once instead of per cell.
+class Atlas {
+    std::vector<Glyph> glyphs;
+    std::vector<GlyphId> cells;
+    Sprite sprites[SPRITE_COUNT];
+
+    Atlas();
+    GlyphId intern(wchar_t ch, int width, Palette color);
+    void add_sprite(SpriteId id, int glyph_width, int height, const wchar_t* rows, Palette color);
+public:
+    static const GlyphId WIDE_TAIL = 0;
+
+    static const Atlas& shared();
+    GlyphId find(wchar_t ch, Palette color = PAL_DEFAULT) const;
+    size_t size() const { return glyphs.size(); }
+    const Glyph& glyph(GlyphId id) const { return glyphs[id]; }
+    const Sprite& sprite(SpriteId id) const { return sprites[id]; }
+    const GlyphId* row(SpriteId id, int r) const { return &cells[sprites[id].first + r * sprites[id].width]; }
+};
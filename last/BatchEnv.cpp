@@ -0,0 +1,122 @@
+#include "BatchEnv.hpp"
+#include <memory>
+#include <new>
+
+// Keeps the NEAREST closest (dx, dy) offsets seen so far, nearest first.
+struct Nearest {
+    int dist[BatchEnv::NEAREST];
+    int16_t pos[BatchEnv::NEAREST][2];
+    int used = 0;
+
+    void offer(int dx, int dy) {
+        int d = dx * dx + dy * dy;
+        if (used == BatchEnv::NEAREST && d >= dist[used - 1]) return;
+        int at = used < BatchEnv::NEAREST ? used++ : used - 1;
+        for (; at > 0 && dist[at - 1] > d; at--) {
+            dist[at] = dist[at - 1];
+            pos[at][0] = pos[at - 1][0];
+            pos[at][1] = pos[at - 1][1];
+        }
+        dist[at] = d;
+        pos[at][0] = dx;
+        pos[at][1] = dy;
+    }
+    void write(int16_t* out) const {
+        for (int k = 0; k < BatchEnv::NEAREST; k++) {
+            out[k * 2] = k < used ? pos[k][0] : int16_t(BatchEnv::EMPTY);
+            out[k * 2 + 1] = k < used ? pos[k][1] : int16_t(BatchEnv::EMPTY);
+        }
+    }
+};
+
+    // Every instance gets the same config, run single-threaded and without a
+    // rewind history; the batch's own job system does the threading.
+    BatchEnv::BatchEnv(size_t count_, const GameConfig& config, int threads) : count(count_),
+        base_seed(config.seed), episode_ticks(config.max_ticks), episodes(count_), jobs(threads),
+        steps(0), finished(0) {
+        GameConfig one = config;
+        one.threads = 1;
+        one.rewind_seconds = 0;
+        one.time_phases = false;
+        games = std::allocator<Game>().allocate(count);
+        for (size_t i = 0; i < count; i++) {
+            one.seed = seed_of(i);
+            new (&games[i]) Game(renderer, one);
+        }
+        obs.player.resize(count * 2);
+        obs.enemies.resize(count * NEAREST * 2);
+        obs.shots.resize(count * NEAREST * 2);
+        obs.score.resize(count);
+        obs.lives.resize(count);
+        obs.ticks.resize(count);
+        obs.done.resize(count);
+        for (size_t i = 0; i < count; i++) observe(i);
+    }
+    BatchEnv::~BatchEnv() {
+        for (size_t i = 0; i < count; i++) games[i].~Game();
+        std::allocator<Game>().deallocate(games, count);
+    }
+    size_t BatchEnv::size() const { return count; }
+    const BatchObservation& BatchEnv::observation() const { return obs; }
+    Game& BatchEnv::game(size_t i) { return games[i]; }
+    long BatchEnv::game_ticks() const { return steps * long(count); }
+    long BatchEnv::episodes_finished() const { return finished; }
+    long BatchEnv::steals() const { return jobs.steals(); }
+
+    unsigned BatchEnv::seed_of(size_t i) const {
+        return base_seed + unsigned(i) + episodes[i] * unsigned(count);
+    }
+
+    // Advances every instance by one tick; input holds one key per instance,
+    // KEY_NONE for none.
+    const BatchObservation& BatchEnv::step(const int* input) {
+        auto shard = [this, input](size_t b, size_t e) { step_range(input, b, e); };
+        jobs.parallel_for(count, GRAIN, shard);
+        for (size_t i = 0; i < count; i++) finished += obs.done[i];
+        steps++;
+        return obs;
+    }
+
+    // Restarts every instance from the first seed of its sequence.
+    void BatchEnv::reset() {
+        for (size_t i = 0; i < count; i++) {
+            episodes[i] = 0;
+            games[i].reset(seed_of(i));
+            obs.done[i] = 0;
+            observe(i);
+        }
+        steps = finished = 0;
+    }
+
+    void BatchEnv::step_range(const int* input, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Game& g = games[i];
+            if (obs.done[i]) {
+                episodes[i]++;
+                g.reset(seed_of(i));
+            }
+            g.tick(input[i]);
+            obs.done[i] = g.game_over || (episode_ticks && g.ticks >= episode_ticks);
+            observe(i);
+        }
+    }
+
+    void BatchEnv::observe(size_t i) {
+        const Game& g = games[i];
+        const int px = g.player.get_x(), py = g.player.get_y();
+        obs.player[i * 2] = px;
+        obs.player[i * 2 + 1] = py;
+        obs.score[i] = g.score;
+        obs.lives[i] = g.player.get_lives();
+        obs.ticks[i] = g.ticks;
+        Nearest enemies, shots;
+        for (size_t e = 0; e < g.enemies.size(); e++)
+            if (g.enemies.alive[e]) enemies.offer(g.enemies.x[e] - px, g.enemies.y[e] - py);
+        for (size_t b = 0; b < g.bosses.size(); b++)
+            if (g.bosses.alive[b]) enemies.offer(g.bosses.x[b] - px, g.bosses.y[b] - py);
+        for (size_t b = 0; b < g.bullets.size(); b++)
+            if (g.bullets.alive[b] && g.bullets.kind[b] == KIND_ENEMY_BULLET)
+                shots.offer(g.bullets.x[b] - px, g.bullets.y[b] - py);
+        enemies.write(&obs.enemies[i * NEAREST * 2]);
+        shots.write(&obs.shots[i * NEAREST * 2]);
+    }
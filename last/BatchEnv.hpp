@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Game.hpp"
+#include "NullRenderer.hpp"
+#include "JobSystem.hpp"
+
+// Results of one BatchEnv step as flat arrays, instance i at index i of the
+// per-instance fields and at i * NEAREST * 2 of the position lists. Enemies
+// and enemy shots are given relative to the player, nearest first, with
+// unused slots set to BatchEnv::EMPTY.
+struct BatchObservation {
+    std::vector<int16_t> player;        // x, y
+    std::vector<int16_t> enemies;       // NEAREST (dx, dy) pairs, bosses included
+    std::vector<int16_t> shots;
+    std::vector<int32_t> score;
+    std::vector<int8_t> lives;
+    std::vector<int32_t> ticks;         // length of the episode so far
+    std::vector<uint8_t> done;          // the episode ended on this step
+};
+
+// N independent games stepped in lockstep from one key per instance, for
+// bots and balancing runs in a single process. The games are built side by
+// side in one array, share a headless renderer and each run on one thread;
+// a step is split across the job system in shards of GRAIN games, and its
+// outcome does not depend on the thread count. An instance whose game ends
+// reports done with its final state once, then restarts on its next step
+// with the next seed of its sequence, reusing its pools.
+class BatchEnv {
+public:
+    static const int NEAREST = 8;
+    static const int16_t EMPTY = INT16_MAX;
+    static const size_t GRAIN = 8;
+
+private:
+    NullRenderer renderer;
+    Game* games;
+    size_t count;
+    unsigned base_seed;
+    long episode_ticks;                 // episode cap, 0 for none
+    std::vector<uint32_t> episodes;     // per instance, numbers its seeds
+    BatchObservation obs;
+    JobSystem jobs;
+    long steps;
+    long finished;
+
+    unsigned seed_of(size_t i) const;
+    void step_range(const int* input, size_t begin, size_t end);
+    void observe(size_t i);
+public:
+    BatchEnv(size_t count_, const GameConfig& config, int threads);
+    ~BatchEnv();
+    BatchEnv(const BatchEnv&) = delete;
+    BatchEnv& operator=(const BatchEnv&) = delete;
+    size_t size() const;
+    long steals() const;
+    const BatchObservation& step(const int* input);
+    const BatchObservation& observation() const;
+    void reset();
+    Game& game(size_t i);
+    long game_ticks() const;
+    long episodes_finished() const;
+};
@@ -1,30 +1,41 @@
 #include "Boss.hpp"
 #include "Constants.hpp"
-#include <cstdlib>
-#include <ncursesw/ncurses.h>
+#include "Emitter.hpp"
+#include <algorithm>
 
 
-    Boss::Boss(int x_, int y_) : GameEntity(x_, y_, [] {
-        cchar_t s;
-        setcchar(&s, L"B", 0, 0, nullptr);
-        return s;
-    }()), health(10), width(2), height(2) {}
-    void Boss::update([[maybe_unused]] int input) {
-        x--;
-        if (x < WIDTH / 2) x = WIDTH / 2;
-        if (rand() % 10 < 2) y += (rand() % 2) ? 1 : -1;
-        if (y < 1) y = 1;
-        if (y > HEIGHT - height) y = HEIGHT - height;
+    EntityHandle Boss::spawn(EntityStore& bosses, int x_, int y_) {
+        return bosses.spawn(x_, y_, -FIX_ONE, 0, KIND_BOSS, max_health);
     }
-    void Boss::render() const {
-        if (active) {
-            for (int i = 0; i < height; i++)
-                for (int j = 0; j < width; j++)
-                    if (y + i < HEIGHT && x + j < WIDTH)
-                        mvadd_wch(y + i, x + j, &symbol);
+    void Boss::update(EntityStore& bosses, const World& world, Rng& rng) {
+        const Rect& arena = world.active;
+        const int min_x = (arena.x0 + arena.width() / 2) * FIX_ONE;
+        const int min_y = (arena.y0 + 1) * FIX_ONE, max_y = (arena.y1 - height) * FIX_ONE;
+        for (size_t i = 0; i < bosses.size(); i++) {
+            bosses.ox[i] = bosses.fx[i];
+            bosses.oy[i] = bosses.fy[i];
+            int x = std::max(bosses.fx[i] + bosses.dx[i], min_x);
+            int y = bosses.fy[i];
+            if (rng.below(10) < 2) y += rng.below(2) ? FIX_ONE : -FIX_ONE;
+            bosses.place(i, x, std::min(std::max(y, min_y), max_y));
         }
     }
-    void Boss::take_damage() { health--; if (health <= 0) active = false; }
-    bool Boss::collides(int px, int py) const {
-        return px >= x && px < x + width && py >= y && py < y + height;
-    }
\ No newline at end of file
+    // Fires on a fixed beat: a turning spiral every fourth tick, a ring
+    // every 45 and an aimed burst every 25, from the middle of its left side.
+    void Boss::fire(const EntityStore& bosses, EntityStore& bullets, long tick, int target_x, int target_y) {
+        for (size_t b = 0; b < bosses.size(); b++) {
+            if (!bosses.alive[b]) continue;
+            const int x = bosses.x[b], y = bosses.y[b] + height / 2;
+            if (tick % 4 == 0) Emitter::emit(bullets, EMIT_SPIRAL, x, y, target_x, target_y, tick / 4);
+            if (tick % 45 == 0) Emitter::emit(bullets, EMIT_RING, x, y, target_x, target_y, tick / 45);
+            if (tick % 25 == 12) Emitter::emit(bullets, EMIT_AIMED, x, y, target_x, target_y, 0);
+        }
+    }
+    void Boss::render(const EntityStore& bosses, FrameBuffer& fb, int cam_x, int cam_y) {
+        for (size_t b = 0; b < bosses.size(); b++)
+            if (bosses.alive[b]) fb.blit(bosses.x[b] - cam_x, bosses.y[b] - cam_y, SPRITE_BOSS);
+    }
+    void Boss::take_damage(EntityStore& bosses, size_t i) {
+        bosses.health[i]--;
+        if (bosses.health[i] <= 0) bosses.kill(i);
+    }
@@ -1,13 +1,18 @@
 #pragma once
-#include "GameEntity.hpp"
+#include "EntityStore.hpp"
+#include "FrameBuffer.hpp"
+#include "Rng.hpp"
+#include "World.hpp"
 
-class Boss : public GameEntity {
-    int health;
-    int width, height;
+class Boss {
 public:
-    Boss(int x_, int y_);
-    void update([[maybe_unused]] int input) override;
-    void render() const override;
-    void take_damage();
-    bool collides(int px, int py) const;
-};
\ No newline at end of file
+    static const int width = 2;
+    static const int height = 2;
+    static const int max_health = 10;
+
+    static EntityHandle spawn(EntityStore& bosses, int x_, int y_);
+    static void update(EntityStore& bosses, const World& world, Rng& rng);
+    static void fire(const EntityStore& bosses, EntityStore& bullets, long tick, int target_x, int target_y);
+    static void render(const EntityStore& bosses, FrameBuffer& fb, int cam_x, int cam_y);
+    static void take_damage(EntityStore& bosses, size_t i);
+};
@@ -1,19 +1,273 @@
 #include "Bullet.hpp"
-#include "Constants.hpp"
-#include <ncursesw/ncurses.h>
-
-    Bullet::Bullet(int x_, int y_, bool player_bullet) : GameEntity(x_, y_, [player_bullet] {
-        cchar_t s;
-        setcchar(&s, player_bullet ? L"|" : L"*", 0, 0, nullptr);
-        return s;
-    }()), is_player_bullet(player_bullet) {}
-    void Bullet::update([[maybe_unused]] int input) {
-        if (is_player_bullet) {
-            x++;
-            if (x >= WIDTH) active = false;
-        } else {
-            x--;
-            if (x < 0) active = false;
+
+#if defined(__x86_64__) && !defined(SHMUP_NO_SIMD)
+#define BULLET_SIMD
+#include <immintrin.h>
+#include <cstring>
+#endif
+
+    EntityHandle Bullet::spawn(EntityStore& bullets, int x_, int y_, bool player_bullet, int speed) {
+        return bullets.spawn(x_, y_, player_bullet ? speed : -speed, 0,
+            player_bullet ? KIND_PLAYER_BULLET : KIND_ENEMY_BULLET);
+    }
+    // An enemy bullet with any fixed-point velocity.
+    EntityHandle Bullet::launch(EntityStore& bullets, int x_, int y_, int vx, int vy) {
+        return bullets.spawn(x_, y_, vx, vy, KIND_ENEMY_BULLET);
+    }
+
+struct Columns {
+    int* x;
+    int* y;
+    int* fx;
+    int* fy;
+    int* ox;
+    int* oy;
+    const int* dx;
+    const int* dy;
+    unsigned char* alive;
+};
+
+static Columns columns(EntityStore& bullets) {
+    return Columns{bullets.x.data(), bullets.y.data(), bullets.fx.data(), bullets.fy.data(), bullets.ox.data(),
+        bullets.oy.data(), bullets.dx.data(), bullets.dy.data(), bullets.alive.data()};
+}
+
+// Movement kernel, instantiated once per world mode. Chunked worlds look up
+// each bullet's step count; uniform ones take the SIMD paths below and
+// finish their tails here.
+template <bool Chunked>
+static void move(const Columns& c, const World& world, size_t begin, size_t end) {
+    const unsigned width = world.width, height = world.height;
+    for (size_t i = begin; i < end; i++) {
+        int steps = Chunked ? world.steps_at(c.x[i], c.y[i]) : 1;
+        c.ox[i] = c.fx[i];
+        c.oy[i] = c.fy[i];
+        c.fx[i] += c.dx[i] * steps;
+        c.fy[i] += c.dy[i] * steps;
+        c.x[i] = c.fx[i] >> FIX_SHIFT;
+        c.y[i] = c.fy[i] >> FIX_SHIFT;
+        c.alive[i] &= (unsigned(c.x[i]) < width) & (unsigned(c.y[i]) < height);
+    }
+}
+
+// Enemy bullets whose path this tick comes near enough to the player's cell
+// for the exact swept test to matter: the path's bounding box overlaps the
+// player's box. Everything else, player shots included, gets 0.
+static void scan(const EntityStore& bullets, int px, int py, size_t begin, size_t end, unsigned char* out) {
+    const int x_lo = px * FIX_ONE - FIX_ONE, x_hi = px * FIX_ONE + FIX_ONE;
+    const int y_lo = py * FIX_ONE - FIX_ONE, y_hi = py * FIX_ONE + FIX_ONE;
+    const int* fx = bullets.fx.data();
+    const int* fy = bullets.fy.data();
+    const int* ox = bullets.ox.data();
+    const int* oy = bullets.oy.data();
+    const unsigned char* kind = bullets.kind.data();
+    const unsigned char* alive = bullets.alive.data();
+    for (size_t i = begin; i < end; i++) {
+        int near = ((ox[i] < x_hi) | (fx[i] < x_hi)) & ((ox[i] > x_lo) | (fx[i] > x_lo))
+            & ((oy[i] < y_hi) | (fy[i] < y_hi)) & ((oy[i] > y_lo) | (fy[i] > y_lo));
+        out[i] = near & alive[i] & (kind[i] == KIND_ENEMY_BULLET);
+    }
+}
+
+#ifdef BULLET_SIMD
+// Lane masks (one bit per bullet, from movemask) to and from the byte columns.
+static inline uint32_t spread4(int bits) { return uint32_t(bits & 15) * 0x00204081u & 0x01010101u; }
+static inline uint64_t spread8(int bits) { return spread4(bits) | uint64_t(spread4(bits >> 4)) << 32; }
+static inline void keep4(unsigned char* p, int bits) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    v &= spread4(bits);
+    memcpy(p, &v, 4);
+}
+static inline void keep8(unsigned char* p, int bits) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    v &= spread8(bits);
+    memcpy(p, &v, 8);
+}
+// Bullets among the n at i that are alive enemy shots.
+static inline int enemy_shots(const unsigned char* kind, const unsigned char* alive, size_t i, int n) {
+    uint64_t k = 0, a = 0;
+    memcpy(&k, kind + i, n);
+    memcpy(&a, alive + i, n);
+    const __m128i kinds = _mm_cvtsi64_si128(k), lives = _mm_cvtsi64_si128(a);
+    int is_enemy = _mm_movemask_epi8(_mm_cmpeq_epi8(kinds, _mm_set1_epi8(KIND_ENEMY_BULLET)));
+    int is_dead = _mm_movemask_epi8(_mm_cmpeq_epi8(lives, _mm_setzero_si128()));
+    return is_enemy & ~is_dead & ((1 << n) - 1);
+}
+
+static void move_sse2(const Columns& c, const World& world, size_t begin, size_t end) {
+    const __m128i minus_one = _mm_set1_epi32(-1);
+    const __m128i width = _mm_set1_epi32(world.width), height = _mm_set1_epi32(world.height);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128i fx = _mm_loadu_si128((const __m128i*)(c.fx + i));
+        __m128i fy = _mm_loadu_si128((const __m128i*)(c.fy + i));
+        _mm_storeu_si128((__m128i*)(c.ox + i), fx);
+        _mm_storeu_si128((__m128i*)(c.oy + i), fy);
+        fx = _mm_add_epi32(fx, _mm_loadu_si128((const __m128i*)(c.dx + i)));
+        fy = _mm_add_epi32(fy, _mm_loadu_si128((const __m128i*)(c.dy + i)));
+        _mm_storeu_si128((__m128i*)(c.fx + i), fx);
+        _mm_storeu_si128((__m128i*)(c.fy + i), fy);
+        __m128i x = _mm_srai_epi32(fx, FIX_SHIFT), y = _mm_srai_epi32(fy, FIX_SHIFT);
+        _mm_storeu_si128((__m128i*)(c.x + i), x);
+        _mm_storeu_si128((__m128i*)(c.y + i), y);
+        __m128i in = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(x, minus_one), _mm_cmpgt_epi32(width, x)),
+            _mm_and_si128(_mm_cmpgt_epi32(y, minus_one), _mm_cmpgt_epi32(height, y)));
+        keep4(c.alive + i, _mm_movemask_ps(_mm_castsi128_ps(in)));
+    }
+    move<false>(c, world, i, end);
+}
+
+__attribute__((target("avx2")))
+static void move_avx2(const Columns& c, const World& world, size_t begin, size_t end) {
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    const __m256i width = _mm256_set1_epi32(world.width), height = _mm256_set1_epi32(world.height);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256i fx = _mm256_loadu_si256((const __m256i*)(c.fx + i));
+        __m256i fy = _mm256_loadu_si256((const __m256i*)(c.fy + i));
+        _mm256_storeu_si256((__m256i*)(c.ox + i), fx);
+        _mm256_storeu_si256((__m256i*)(c.oy + i), fy);
+        fx = _mm256_add_epi32(fx, _mm256_loadu_si256((const __m256i*)(c.dx + i)));
+        fy = _mm256_add_epi32(fy, _mm256_loadu_si256((const __m256i*)(c.dy + i)));
+        _mm256_storeu_si256((__m256i*)(c.fx + i), fx);
+        _mm256_storeu_si256((__m256i*)(c.fy + i), fy);
+        __m256i x = _mm256_srai_epi32(fx, FIX_SHIFT), y = _mm256_srai_epi32(fy, FIX_SHIFT);
+        _mm256_storeu_si256((__m256i*)(c.x + i), x);
+        _mm256_storeu_si256((__m256i*)(c.y + i), y);
+        __m256i in = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(x, minus_one), _mm256_cmpgt_epi32(width, x)),
+            _mm256_and_si256(_mm256_cmpgt_epi32(y, minus_one), _mm256_cmpgt_epi32(height, y)));
+        keep8(c.alive + i, _mm256_movemask_ps(_mm256_castsi256_ps(in)));
+    }
+    move<false>(c, world, i, end);
+}
+
+// Lanes where a or b is above lo, or below hi: the path's extent on one
+// axis reaches past that bound.
+static inline __m128i above(__m128i a, __m128i b, __m128i lo) {
+    return _mm_or_si128(_mm_cmpgt_epi32(a, lo), _mm_cmpgt_epi32(b, lo));
+}
+static inline __m128i below(__m128i a, __m128i b, __m128i hi) {
+    return _mm_or_si128(_mm_cmpgt_epi32(hi, a), _mm_cmpgt_epi32(hi, b));
+}
+
+static void scan_sse2(const EntityStore& bullets, int px, int py, size_t begin, size_t end, unsigned char* out) {
+    const __m128i x_lo = _mm_set1_epi32(px * FIX_ONE - FIX_ONE), x_hi = _mm_set1_epi32(px * FIX_ONE + FIX_ONE);
+    const __m128i y_lo = _mm_set1_epi32(py * FIX_ONE - FIX_ONE), y_hi = _mm_set1_epi32(py * FIX_ONE + FIX_ONE);
+    const int* fx = bullets.fx.data();
+    const int* fy = bullets.fy.data();
+    const int* ox = bullets.ox.data();
+    const int* oy = bullets.oy.data();
+    const unsigned char* kind = bullets.kind.data();
+    const unsigned char* alive = bullets.alive.data();
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128i x0 = _mm_loadu_si128((const __m128i*)(ox + i)), x1 = _mm_loadu_si128((const __m128i*)(fx + i));
+        __m128i y0 = _mm_loadu_si128((const __m128i*)(oy + i)), y1 = _mm_loadu_si128((const __m128i*)(fy + i));
+        __m128i near = _mm_and_si128(_mm_and_si128(below(x0, x1, x_hi), above(x0, x1, x_lo)),
+            _mm_and_si128(below(y0, y1, y_hi), above(y0, y1, y_lo)));
+        uint32_t v = spread4(_mm_movemask_ps(_mm_castsi128_ps(near)) & enemy_shots(kind, alive, i, 4));
+        memcpy(out + i, &v, 4);
+    }
+    scan(bullets, px, py, i, end, out);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i above(__m256i a, __m256i b, __m256i lo) {
+    return _mm256_or_si256(_mm256_cmpgt_epi32(a, lo), _mm256_cmpgt_epi32(b, lo));
+}
+__attribute__((target("avx2")))
+static inline __m256i below(__m256i a, __m256i b, __m256i hi) {
+    return _mm256_or_si256(_mm256_cmpgt_epi32(hi, a), _mm256_cmpgt_epi32(hi, b));
+}
+
+__attribute__((target("avx2")))
+static void scan_avx2(const EntityStore& bullets, int px, int py, size_t begin, size_t end, unsigned char* out) {
+    const __m256i x_lo = _mm256_set1_epi32(px * FIX_ONE - FIX_ONE), x_hi = _mm256_set1_epi32(px * FIX_ONE + FIX_ONE);
+    const __m256i y_lo = _mm256_set1_epi32(py * FIX_ONE - FIX_ONE), y_hi = _mm256_set1_epi32(py * FIX_ONE + FIX_ONE);
+    const int* fx = bullets.fx.data();
+    const int* fy = bullets.fy.data();
+    const int* ox = bullets.ox.data();
+    const int* oy = bullets.oy.data();
+    const unsigned char* kind = bullets.kind.data();
+    const unsigned char* alive = bullets.alive.data();
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256i x0 = _mm256_loadu_si256((const __m256i*)(ox + i)), x1 = _mm256_loadu_si256((const __m256i*)(fx + i));
+        __m256i y0 = _mm256_loadu_si256((const __m256i*)(oy + i)), y1 = _mm256_loadu_si256((const __m256i*)(fy + i));
+        __m256i near = _mm256_and_si256(_mm256_and_si256(below(x0, x1, x_hi), above(x0, x1, x_lo)),
+            _mm256_and_si256(below(y0, y1, y_hi), above(y0, y1, y_lo)));
+        uint64_t v = spread8(_mm256_movemask_ps(_mm256_castsi256_ps(near)) & enemy_shots(kind, alive, i, 8));
+        memcpy(out + i, &v, 8);
+    }
+    scan(bullets, px, py, i, end, out);
+}
+#endif
+
+    void Bullet::update(EntityStore& bullets, const World& world, size_t begin, size_t end) {
+        update(bullets, world, begin, end, best_kernel());
+    }
+    void Bullet::update(EntityStore& bullets, const World& world, size_t begin, size_t end, BulletKernel kernel) {
+        const Columns c = columns(bullets);
+        if (!world.uniform) {
+            move<true>(c, world, begin, end);
+            return;
+        }
+        switch (kernel) {
+#ifdef BULLET_SIMD
+        case KERNEL_SSE2:
+            move_sse2(c, world, begin, end);
+            break;
+        case KERNEL_AVX2:
+            move_avx2(c, world, begin, end);
+            break;
+#endif
+        default:
+            move<false>(c, world, begin, end);
+            break;
         }
     }
-    bool Bullet::is_from_player() const { return is_player_bullet; }
\ No newline at end of file
+    void Bullet::threats(const EntityStore& bullets, int px, int py, size_t begin, size_t end, unsigned char* out) {
+        threats(bullets, px, py, begin, end, out, best_kernel());
+    }
+    void Bullet::threats(const EntityStore& bullets, int px, int py, size_t begin, size_t end, unsigned char* out,
+        BulletKernel kernel) {
+        switch (kernel) {
+#ifdef BULLET_SIMD
+        case KERNEL_SSE2:
+            scan_sse2(bullets, px, py, begin, end, out);
+            break;
+        case KERNEL_AVX2:
+            scan_avx2(bullets, px, py, begin, end, out);
+            break;
+#endif
+        default:
+            scan(bullets, px, py, begin, end, out);
+            break;
+        }
+    }
+    BulletKernel Bullet::best_kernel() {
+#ifdef BULLET_SIMD
+        static const BulletKernel best = __builtin_cpu_supports("avx2") ? KERNEL_AVX2 : KERNEL_SSE2;
+        return best;
+#else
+        return KERNEL_SCALAR;
+#endif
+    }
+    bool Bullet::supported(BulletKernel kernel) {
+        return kernel <= best_kernel();
+    }
+    const char* Bullet::kernel_name(BulletKernel kernel) {
+        static const char* const names[KERNEL_COUNT] = {"scalar", "sse2", "avx2"};
+        return kernel < KERNEL_COUNT ? names[kernel] : "?";
+    }
+    void Bullet::render(const EntityStore& bullets, FrameBuffer& fb, int cam_x, int cam_y) {
+        for (size_t i = 0; i < bullets.size(); i++)
+            if (bullets.alive[i])
+                fb.blit(bullets.x[i] - cam_x, bullets.y[i] - cam_y,
+                    bullets.kind[i] == KIND_PLAYER_BULLET ? SPRITE_PLAYER_BULLET : SPRITE_ENEMY_BULLET);
+    }
+    bool Bullet::is_from_player(const EntityStore& bullets, size_t i) {
+        return bullets.kind[i] == KIND_PLAYER_BULLET;
+    }
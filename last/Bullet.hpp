@@ -1,10 +1,30 @@
 #pragma once
-#include "GameEntity.hpp"
+#include "EntityStore.hpp"
+#include "FrameBuffer.hpp"
+#include "World.hpp"
+#include "Constants.hpp"
 
-class Bullet : public GameEntity {
-    bool is_player_bullet;
+// Implementations of the per-bullet sweeps. All of them produce the same
+// bytes; best_kernel() picks the widest one the CPU runs.
+enum BulletKernel : unsigned char {
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2,
+    KERNEL_COUNT
+};
+
+class Bullet {
 public:
-    Bullet(int x_, int y_, bool player_bullet);
-    void update([[maybe_unused]] int input) override;
-    bool is_from_player() const;
-};
\ No newline at end of file
+    static EntityHandle spawn(EntityStore& bullets, int x_, int y_, bool player_bullet, int speed = FIX_ONE);
+    static EntityHandle launch(EntityStore& bullets, int x_, int y_, int vx, int vy);
+    static void update(EntityStore& bullets, const World& world, size_t begin, size_t end);
+    static void update(EntityStore& bullets, const World& world, size_t begin, size_t end, BulletKernel kernel);
+    static void threats(const EntityStore& bullets, int px, int py, size_t begin, size_t end, unsigned char* out);
+    static void threats(const EntityStore& bullets, int px, int py, size_t begin, size_t end, unsigned char* out,
+        BulletKernel kernel);
+    static BulletKernel best_kernel();
+    static bool supported(BulletKernel kernel);
+    static const char* kernel_name(BulletKernel kernel);
+    static void render(const EntityStore& bullets, FrameBuffer& fb, int cam_x, int cam_y);
+    static bool is_from_player(const EntityStore& bullets, size_t i);
+};
@@ -3,5 +3,20 @@
 const int WIDTH = 80;
 const int HEIGHT = 24;
 const int FPS = 15; // Замедлено для удобства
+const int RENDER_FPS = 30;
+const int MAX_CATCHUP_TICKS = 5;
+const int MAX_KEYS_PER_TICK = 16;
 const int PLAYER_LIVES = 3;
-const int BOSS_SCORE_THRESHOLD = 50;
\ No newline at end of file
+const int KEY_NONE = -1; // same value as ncurses ERR
+const int BOSS_SCORE_THRESHOLD = 50;
+const int BOSS_SPAWN_SCORE = 10; // awarded when a boss appears, scripted or not
+const int BULLET_CAPACITY = 1024;
+const int ENEMY_CAPACITY = 256;
+const int BOSS_CAPACITY = 4;
+const int BULLET_GRAIN = 256; // bullets per job-system chunk; the default pool splits four ways
+const int ENEMY_GRAIN = 64; // enemies per chunk, fewer since each one does more work
+const int REWIND_SECONDS = 5; // history kept for the rewind key
+const int MESSAGE_LINES = 3; // HUD messages shown at once, newest on top
+const int MESSAGE_TICKS = 2 * FPS; // how long a HUD message stays up
+const int FIX_SHIFT = 8; // fractional bits of fixed-point positions and velocities
+const int FIX_ONE = 1 << FIX_SHIFT;
\ No newline at end of file
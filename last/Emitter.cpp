@@ -0,0 +1,60 @@
+#include "Emitter.hpp"
+#include "Bullet.hpp"
+#include "Constants.hpp"
+
+// cos, sin of k * 2pi / DIRECTIONS, times 256; y grows downward.
+static const int16_t directions[Emitter::DIRECTIONS][2] = {
+    {256, 0}, {255, 25}, {251, 50}, {245, 74}, {237, 98}, {226, 121}, {213, 142}, {198, 162},
+    {181, 181}, {162, 198}, {142, 213}, {121, 226}, {98, 237}, {74, 245}, {50, 251}, {25, 255},
+    {0, 256}, {-25, 255}, {-50, 251}, {-74, 245}, {-98, 237}, {-121, 226}, {-142, 213}, {-162, 198},
+    {-181, 181}, {-198, 162}, {-213, 142}, {-226, 121}, {-237, 98}, {-245, 74}, {-251, 50}, {-255, 25},
+    {-256, 0}, {-255, -25}, {-251, -50}, {-245, -74}, {-237, -98}, {-226, -121}, {-213, -142}, {-198, -162},
+    {-181, -181}, {-162, -198}, {-142, -213}, {-121, -226}, {-98, -237}, {-74, -245}, {-50, -251}, {-25, -255},
+    {0, -256}, {25, -255}, {50, -251}, {74, -245}, {98, -237}, {121, -226}, {142, -213}, {162, -198},
+    {181, -181}, {198, -162}, {213, -142}, {226, -121}, {237, -98}, {245, -74}, {251, -50}, {255, -25},
+};
+
+    void Emitter::shoot(EntityStore& bullets, int x, int y, int dir, int speed) {
+        const int16_t* d = directions[dir & (DIRECTIONS - 1)];
+        Bullet::launch(bullets, x, y, d[0] * speed / 256, d[1] * speed / 512);
+    }
+    // Table direction closest to (dx, dy), in screen proportions.
+    int Emitter::aim(int dx, int dy) {
+        int best = LEFT;
+        int64_t best_dot = INT64_MIN;
+        for (int k = 0; k < DIRECTIONS; k++) {
+            int64_t dot = int64_t(directions[k][0]) * dx + int64_t(directions[k][1]) * dy * 2;
+            if (dot > best_dot) {
+                best_dot = dot;
+                best = k;
+            }
+        }
+        return best;
+    }
+    // Bullets start one cell left of (x, y), in front of the shooter.
+    void Emitter::emit(EntityStore& bullets, EmitPattern pattern, int x, int y, int target_x, int target_y,
+        uint32_t phase) {
+        x--;
+        switch (pattern) {
+        case EMIT_SHOT:
+            Bullet::spawn(bullets, x, y, false);
+            break;
+        case EMIT_FAN:
+            for (int k = -2; k <= 2; k++) shoot(bullets, x, y, LEFT + k * 3, FIX_ONE * 3 / 4);
+            break;
+        case EMIT_RING:
+            for (int k = 0; k < 16; k++) shoot(bullets, x, y, k * DIRECTIONS / 16 + int(phase % 4), FIX_ONE / 2);
+            break;
+        case EMIT_SPIRAL:
+            shoot(bullets, x, y, int(phase * 3), FIX_ONE / 2);
+            shoot(bullets, x, y, int(phase * 3) + DIRECTIONS / 2, FIX_ONE / 2);
+            break;
+        case EMIT_AIMED: {
+            int dir = aim(target_x - x, target_y - y);
+            for (int k = 0; k < 3; k++) shoot(bullets, x, y, dir, FIX_ONE - k * FIX_ONE / 4);
+            break;
+        }
+        default:
+            break;
+        }
+    }
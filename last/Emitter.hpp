@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include "EntityStore.hpp"
+
+enum EmitPattern : unsigned char {
+    EMIT_SHOT,                          // one bullet straight left
+    EMIT_FAN,                           // five bullets spread around left
+    EMIT_RING,                          // sixteen bullets all around, turned by the phase
+    EMIT_SPIRAL,                        // two opposite arms that turn with the phase
+    EMIT_AIMED,                         // three bullets at the target, fastest first
+    EMIT_PATTERN_COUNT
+};
+
+// Spawns enemy bullet patterns. Directions come from a fixed table of
+// DIRECTIONS unit vectors in 1/256ths, so every velocity is integer and a
+// pattern comes out the same on any machine. Vertical speed is halved
+// because terminal cells are about twice as tall as they are wide.
+class Emitter {
+public:
+    static const int DIRECTIONS = 64;
+    static const int LEFT = DIRECTIONS / 2;
+
+    static void emit(EntityStore& bullets, EmitPattern pattern, int x, int y, int target_x, int target_y,
+        uint32_t phase);
+    static void shoot(EntityStore& bullets, int x, int y, int dir, int speed);
+    static int aim(int dx, int dy);
+};
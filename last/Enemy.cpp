@@ -1,19 +1,85 @@
 #include "Enemy.hpp"
+#include "Bullet.hpp"
+#include "Emitter.hpp"
 #include "Constants.hpp"
-#include <cstdlib>
 
-    Enemy::Enemy(int x_, int y_, bool scripted) : GameEntity(x_, y_, [] {
-        cchar_t s;
-        setcchar(&s, L"E", 0, 0, nullptr);
-        return s;
-    }()), is_scripted(scripted) {}
-    void Enemy::update([[maybe_unused]] int input) {
-        x--;
-        if (is_scripted && rand() % 10 < 3) {
-            int player_y = 12;
-            if (y < player_y && y < HEIGHT - 1) y++;
-            else if (y > player_y && y > 1) y--;
+static const uint32_t fire_threshold[FIRE_PATTERN_COUNT] = {5, 0, 15, 2, 2};
+static const EmitPattern fire_emit[FIRE_PATTERN_COUNT] = {EMIT_SHOT, EMIT_SHOT, EMIT_SHOT, EMIT_FAN, EMIT_AIMED};
+
+    EntityHandle Enemy::spawn(EntityStore& enemies, int x_, int y_, bool scripted) {
+        return spawn(enemies, x_, y_, scripted ? MOVE_CHASE : MOVE_STRAIGHT, FIRE_RANDOM);
+    }
+    EntityHandle Enemy::spawn(EntityStore& enemies, int x_, int y_, MovePattern move, FirePattern fire) {
+        return enemies.spawn(x_, y_, -FIX_ONE, 0, move == MOVE_STRAIGHT ? KIND_ENEMY : KIND_SCRIPTED_ENEMY, 1,
+            move | fire << 4);
+    }
+// Movement kernel, instantiated once per world mode. Every pattern shares
+// one branch-free body: each step is masked by the move pattern, and
+// pursuit reads the shared flow field at the enemy's cell.
+template <bool Chunked>
+static void move(EntityStore& enemies, const World& world, const FlowField& field, const uint32_t* move_rolls,
+    const uint32_t* fire_rolls, unsigned char* shoot, size_t begin, size_t end) {
+    const int max_y = world.height - 1;
+    int* xs = enemies.x.data();
+    int* ys = enemies.y.data();
+    int* fx = enemies.fx.data();
+    int* fy = enemies.fy.data();
+    int* ox = enemies.ox.data();
+    int* oy = enemies.oy.data();
+    const int* dxs = enemies.dx.data();
+    const unsigned char* patterns = enemies.pattern.data();
+    unsigned char* alive = enemies.alive.data();
+    for (size_t i = begin; i < end; i++) {
+        int y = ys[i];
+        int steps = Chunked ? world.steps_at(xs[i], y) : 1;
+        ox[i] = fx[i];
+        oy[i] = fy[i];
+        if (Chunked && steps == 0) {
+            shoot[i] = 0;
+            continue;
         }
-        if (x < 0) active = false;
+        int move = patterns[i] & 15, fire = patterns[i] >> 4;
+        int cell = field.index(xs[i], y);
+        int home = move == MOVE_HOME;
+        int stride = home & (move_rolls[i] < 5);
+        int chase = (move == MOVE_CHASE) & (move_rolls[i] < 3);
+        fx[i] += (1 - home) * dxs[i] * steps + stride * field.dx(cell) * FIX_ONE;
+        int old_x = xs[i];
+        xs[i] = fx[i] >> FIX_SHIFT;
+        int zig = (move == MOVE_ZIGZAG) & ((xs[i] >> 2) != (old_x >> 2));
+        int dir = (xs[i] >> 2) & 1 ? 1 : -1;
+        zig &= (y + dir >= 1) & (y + dir <= max_y);
+        fy[i] += ((chase + stride) * field.dy(cell) + zig * dir) * FIX_ONE;
+        ys[i] = fy[i] >> FIX_SHIFT;
+        alive[i] &= xs[i] >= 0;
+        shoot[i] = alive[i] & (fire_rolls[i] < fire_threshold[fire]);
+    }
+}
+
+    void Enemy::update(EntityStore& enemies, const World& world, const FlowField& field, const uint32_t* move_rolls,
+        const uint32_t* fire_rolls, unsigned char* shoot, size_t begin, size_t end) {
+        if (world.uniform) move<false>(enemies, world, field, move_rolls, fire_rolls, shoot, begin, end);
+        else move<true>(enemies, world, field, move_rolls, fire_rolls, shoot, begin, end);
+    }
+    // Whether any enemy reads the flow field; without one it need not be kept current.
+    bool Enemy::pursuing(const EntityStore& enemies) {
+        for (unsigned char p : enemies.pattern) {
+            int move = p & 15;
+            if (move == MOVE_CHASE || move == MOVE_HOME) return true;
+        }
+        return false;
+    }
+    void Enemy::fire(const EntityStore& enemies, EntityStore& bullets, const unsigned char* shoot, int target_x,
+        int target_y) {
+        const size_t n = enemies.size();
+        for (size_t i = 0; i < n; i++)
+            if (shoot[i])
+                Emitter::emit(bullets, fire_emit[enemies.pattern[i] >> 4], enemies.x[i], enemies.y[i],
+                    target_x, target_y, 0);
+    }
+    void Enemy::render(const EntityStore& enemies, FrameBuffer& fb, int cam_x, int cam_y) {
+        for (size_t i = 0; i < enemies.size(); i++)
+            if (enemies.alive[i])
+                fb.blit(enemies.x[i] - cam_x, enemies.y[i] - cam_y,
+                    enemies.kind[i] == KIND_SCRIPTED_ENEMY ? SPRITE_SCRIPTED_ENEMY : SPRITE_ENEMY);
     }
-    bool Enemy::can_shoot() const { return rand() % 100 < 5; }
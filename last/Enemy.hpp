@@ -1,10 +1,37 @@
 #pragma once
-#include "GameEntity.hpp"
+#include "EntityStore.hpp"
+#include "FrameBuffer.hpp"
+#include "World.hpp"
+#include "FlowField.hpp"
+#include <cstdint>
 
-class Enemy : public GameEntity {
-    bool is_scripted;
+enum MovePattern : unsigned char {
+    MOVE_STRAIGHT,
+    MOVE_CHASE,                         // drift toward the player's row along the flow field
+    MOVE_ZIGZAG,                        // step up or down every 4 columns
+    MOVE_HOME,                          // follow the flow field on both axes, at half speed
+    MOVE_PATTERN_COUNT
+};
+
+enum FirePattern : unsigned char {
+    FIRE_RANDOM,
+    FIRE_NONE,
+    FIRE_BURST,                         // three times the usual rate
+    FIRE_FAN,                           // a five-way spread, less often
+    FIRE_AIMED,                         // three shots at the player, less often
+    FIRE_PATTERN_COUNT
+};
+
+// An enemy's EntityStore::pattern packs its MovePattern in the low nibble
+// and its FirePattern in the high one.
+class Enemy {
 public:
-    Enemy(int x_, int y_, bool scripted = false);
-    void update([[maybe_unused]] int input) override;
-    bool can_shoot() const;
+    static EntityHandle spawn(EntityStore& enemies, int x_, int y_, bool scripted = false);
+    static EntityHandle spawn(EntityStore& enemies, int x_, int y_, MovePattern move, FirePattern fire);
+    static void update(EntityStore& enemies, const World& world, const FlowField& field, const uint32_t* move_rolls,
+        const uint32_t* fire_rolls, unsigned char* shoot, size_t begin, size_t end);
+    static bool pursuing(const EntityStore& enemies);
+    static void fire(const EntityStore& enemies, EntityStore& bullets, const unsigned char* shoot, int target_x,
+        int target_y);
+    static void render(const EntityStore& enemies, FrameBuffer& fb, int cam_x, int cam_y);
 };
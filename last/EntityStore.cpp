@@ -0,0 +1,247 @@
+#include "EntityStore.hpp"
+#include "Constants.hpp"
+
+    EntityStore::EntityStore(size_t capacity, PoolPolicy policy_) : first_slot(NO_SLOT), last_slot(NO_SLOT),
+        dead_scan(0), cap(0), policy(policy_),
+        growths(0), dropped(0), recycled(0) {
+        reserve(capacity);
+        growths = 0;
+    }
+    void EntityStore::reserve(size_t n) {
+        x.reserve(n);
+        y.reserve(n);
+        fx.reserve(n);
+        fy.reserve(n);
+        ox.reserve(n);
+        oy.reserve(n);
+        dx.reserve(n);
+        dy.reserve(n);
+        health.reserve(n);
+        kind.reserve(n);
+        pattern.reserve(n);
+        alive.reserve(n);
+        slot.reserve(n);
+        dense_of.resize(n);
+        generation.resize(n, 0);
+        free_slots.reserve(n);
+        older.resize(n, uint32_t(NO_SLOT));
+        newer.resize(n, uint32_t(NO_SLOT));
+        for (size_t s = n; s > cap; s--) free_slots.push_back(s - 1);
+        cap = n;
+        growths++;
+    }
+    void EntityStore::link(uint32_t s) {
+        older[s] = last_slot;
+        newer[s] = NO_SLOT;
+        if (last_slot != NO_SLOT) newer[last_slot] = s;
+        else first_slot = s;
+        last_slot = s;
+    }
+    void EntityStore::unlink(uint32_t s) {
+        if (older[s] != NO_SLOT) newer[older[s]] = newer[s];
+        else first_slot = newer[s];
+        if (newer[s] != NO_SLOT) older[newer[s]] = older[s];
+        else last_slot = older[s];
+    }
+    // The entity a full recycling pool overwrites: one that is already dead
+    // but not compacted yet if there is any, otherwise the oldest. The scan
+    // cursor only moves forward until the next compaction, so looking for the
+    // dead costs O(1) amortized per spawn.
+    size_t EntityStore::victim() {
+        for (; dead_scan < size(); dead_scan++)
+            if (!alive[dead_scan]) return dead_scan++;
+        return dense_of[first_slot];
+    }
+    size_t EntityStore::size() const { return x.size(); }
+    bool EntityStore::empty() const { return x.empty(); }
+    size_t EntityStore::capacity() const { return cap; }
+    EntityHandle EntityStore::spawn(int x_, int y_, int dx_, int dy_, unsigned char kind_, int health_,
+        unsigned char pattern_) {
+        if (free_slots.empty()) {
+            if (policy == POOL_DROP || cap == 0) {
+                dropped++;
+                return EntityHandle{UINT32_MAX, 0};
+            }
+            if (policy == POOL_GROW) {
+                reserve(cap * 2);
+            } else {
+                size_t i = victim();
+                generation[slot[i]]++;
+                unlink(slot[i]);
+                link(slot[i]);
+                x[i] = x_;
+                y[i] = y_;
+                fx[i] = ox[i] = x_ * FIX_ONE;
+                fy[i] = oy[i] = y_ * FIX_ONE;
+                dx[i] = dx_;
+                dy[i] = dy_;
+                health[i] = health_;
+                kind[i] = kind_;
+                pattern[i] = pattern_;
+                alive[i] = 1;
+                recycled++;
+                return handle(i);
+            }
+        }
+        uint32_t s = free_slots.back();
+        free_slots.pop_back();
+        dense_of[s] = x.size();
+        x.push_back(x_);
+        y.push_back(y_);
+        fx.push_back(x_ * FIX_ONE);
+        fy.push_back(y_ * FIX_ONE);
+        ox.push_back(x_ * FIX_ONE);
+        oy.push_back(y_ * FIX_ONE);
+        dx.push_back(dx_);
+        dy.push_back(dy_);
+        health.push_back(health_);
+        kind.push_back(kind_);
+        pattern.push_back(pattern_);
+        alive.push_back(1);
+        slot.push_back(s);
+        link(s);
+        return EntityHandle{s, generation[s]};
+    }
+    EntityHandle EntityStore::handle(size_t i) const { return EntityHandle{slot[i], generation[slot[i]]}; }
+    long EntityStore::index_of(EntityHandle h) const {
+        if (!h.valid() || h.slot >= cap || generation[h.slot] != h.generation) return -1;
+        return dense_of[h.slot];
+    }
+    void EntityStore::kill(size_t i) { alive[i] = 0; }
+    // Moves entity i to a fixed-point position and refreshes its cell.
+    void EntityStore::place(size_t i, int fx_, int fy_) {
+        fx[i] = fx_;
+        fy[i] = fy_;
+        x[i] = fx_ >> FIX_SHIFT;
+        y[i] = fy_ >> FIX_SHIFT;
+    }
+    void EntityStore::compact() {
+        size_t n = size();
+        size_t i = 0;
+        while (i < n) {
+            if (alive[i]) {
+                i++;
+                continue;
+            }
+            generation[slot[i]]++;
+            free_slots.push_back(slot[i]);
+            unlink(slot[i]);
+            n--;
+            x[i] = x[n];
+            y[i] = y[n];
+            fx[i] = fx[n];
+            fy[i] = fy[n];
+            ox[i] = ox[n];
+            oy[i] = oy[n];
+            dx[i] = dx[n];
+            dy[i] = dy[n];
+            health[i] = health[n];
+            kind[i] = kind[n];
+            pattern[i] = pattern[n];
+            alive[i] = alive[n];
+            slot[i] = slot[n];
+            dense_of[slot[i]] = i;
+        }
+        x.resize(n);
+        y.resize(n);
+        fx.resize(n);
+        fy.resize(n);
+        ox.resize(n);
+        oy.resize(n);
+        dx.resize(n);
+        dy.resize(n);
+        health.resize(n);
+        kind.resize(n);
+        pattern.resize(n);
+        alive.resize(n);
+        slot.resize(n);
+        dead_scan = 0;
+    }
+    void EntityStore::clear() {
+        for (size_t i = 0; i < size(); i++) alive[i] = 0;
+        compact();
+    }
+    long EntityStore::allocations() const { return growths; }
+    long EntityStore::dropped_spawns() const { return dropped; }
+    long EntityStore::recycled_spawns() const { return recycled; }
+    void EntityStore::save(SnapshotWriter& out) const {
+        out.put(uint32_t(cap));
+        out.put(uint32_t(size()));
+        out.put(uint32_t(free_slots.size()));
+        out.put(first_slot);
+        out.put(last_slot);
+        out.put(growths);
+        out.put(dropped);
+        out.put(recycled);
+        out.put_array(x, cap);
+        out.put_array(y, cap);
+        out.put_array(fx, cap);
+        out.put_array(fy, cap);
+        out.put_array(ox, cap);
+        out.put_array(oy, cap);
+        out.put_array(dx, cap);
+        out.put_array(dy, cap);
+        out.put_array(health, cap);
+        out.put_array(kind, cap);
+        out.put_array(pattern, cap);
+        out.put_array(alive, cap);
+        out.put_array(slot, cap);
+        out.put_array(dense_of, cap);
+        out.put_array(generation, cap);
+        out.put_array(free_slots, cap);
+        out.put_array(older, cap);
+        out.put_array(newer, cap);
+    }
+    // Storage only grows here when the snapshot's pool outgrew this one.
+    bool EntityStore::load(SnapshotReader& in) {
+        uint32_t stored_cap = 0, n = 0, free_count = 0;
+        in.get(stored_cap);
+        in.get(n);
+        in.get(free_count);
+        if (!in.ok() || n > stored_cap || free_count > stored_cap) return false;
+        // Four slot-indexed arrays follow at this stride; a capacity the
+        // rest of the buffer cannot hold is corrupt, and must not be reserved.
+        if (in.remaining() / (4 * sizeof(uint32_t)) < stored_cap) return false;
+        if (stored_cap > cap) {
+            long g = growths;
+            reserve(stored_cap);
+            growths = g;
+        }
+        cap = stored_cap;
+        in.get(first_slot);
+        in.get(last_slot);
+        in.get(growths);
+        in.get(dropped);
+        in.get(recycled);
+        in.get_array(x, n, cap);
+        in.get_array(y, n, cap);
+        in.get_array(fx, n, cap);
+        in.get_array(fy, n, cap);
+        in.get_array(ox, n, cap);
+        in.get_array(oy, n, cap);
+        in.get_array(dx, n, cap);
+        in.get_array(dy, n, cap);
+        in.get_array(health, n, cap);
+        in.get_array(kind, n, cap);
+        in.get_array(pattern, n, cap);
+        in.get_array(alive, n, cap);
+        in.get_array(slot, n, cap);
+        in.get_array(dense_of, cap, cap);
+        in.get_array(generation, cap, cap);
+        in.get_array(free_slots, free_count, cap);
+        in.get_array(older, cap, cap);
+        in.get_array(newer, cap, cap);
+        dead_scan = 0;
+        if (!in.ok() || n + free_count != cap) return false;
+        // Every index below is followed later without a bounds check, so a
+        // corrupt snapshot is refused here rather than read out of range.
+        auto linked = [this](uint32_t s) { return s == NO_SLOT || s < cap; };
+        if (!linked(first_slot) || !linked(last_slot)) return false;
+        for (uint32_t i = 0; i < n; i++)
+            if (slot[i] >= cap || dense_of[slot[i]] != i) return false;
+        for (uint32_t s = 0; s < cap; s++)
+            if (dense_of[s] >= cap || !linked(older[s]) || !linked(newer[s])) return false;
+        for (uint32_t f : free_slots)
+            if (f >= cap) return false;
+        return true;
+    }
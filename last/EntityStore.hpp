@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Snapshot.hpp"
+
+enum EntityKind : unsigned char {
+    KIND_PLAYER_BULLET,
+    KIND_ENEMY_BULLET,
+    KIND_ENEMY,
+    KIND_SCRIPTED_ENEMY,
+    KIND_BOSS
+};
+
+// What spawn() does once every preallocated slot is taken.
+enum PoolPolicy : unsigned char {
+    POOL_DROP,
+    POOL_RECYCLE_OLDEST,
+    POOL_GROW
+};
+
+struct EntityHandle {
+    uint32_t slot;
+    uint32_t generation;
+    bool valid() const { return slot != UINT32_MAX; }
+};
+
+// Structure-of-arrays pool for one family of entities. Index i across the
+// dense arrays is one entity. fx/fy are the fixed-point positions (FIX_SHIFT
+// fractional bits) that movement integrates, ox/oy where the entity started
+// this tick, and x/y the cell it occupies; dx/dy are fixed-point velocities.
+// Dead entities are removed by swap-remove in compact(). Storage is reserved
+// up front, and handles stay valid across compaction until the entity they
+// name is removed or recycled. Slots are also threaded into a list in spawn
+// order, so a full recycling pool finds the oldest entity in O(1).
+class EntityStore {
+public:
+    std::vector<int> x, y;
+    std::vector<int> fx, fy;
+    std::vector<int> ox, oy;
+    std::vector<int> dx, dy;
+    std::vector<int> health;
+    std::vector<unsigned char> kind;
+    std::vector<unsigned char> pattern;  // per-kind behaviour, e.g. Enemy move/fire patterns
+    std::vector<unsigned char> alive;
+
+private:
+    std::vector<uint32_t> slot;         // dense index -> slot
+    std::vector<uint32_t> dense_of;     // slot -> dense index
+    std::vector<uint32_t> generation;   // slot -> generation
+    std::vector<uint32_t> free_slots;
+    std::vector<uint32_t> older;        // slot -> slot spawned just before it, NO_SLOT at the oldest
+    std::vector<uint32_t> newer;        // slot -> slot spawned just after it
+    uint32_t first_slot;                // oldest live slot, NO_SLOT when empty
+    uint32_t last_slot;
+    size_t dead_scan;                   // dense indices below this were checked for dead entities
+    size_t cap;
+    PoolPolicy policy;
+    long growths;
+    long dropped;
+    long recycled;
+
+    static const uint32_t NO_SLOT = UINT32_MAX;
+
+    void reserve(size_t n);
+    void link(uint32_t s);
+    void unlink(uint32_t s);
+    size_t victim();
+
+public:
+    EntityStore(size_t capacity, PoolPolicy policy_);
+    size_t size() const;
+    bool empty() const;
+    size_t capacity() const;
+    EntityHandle spawn(int x_, int y_, int dx_, int dy_, unsigned char kind_, int health_ = 1,
+        unsigned char pattern_ = 0);
+    EntityHandle handle(size_t i) const;
+    long index_of(EntityHandle h) const;
+    void kill(size_t i);
+    void place(size_t i, int fx_, int fy_);
+    void compact();
+    void clear();
+    long allocations() const;
+    long dropped_spawns() const;
+    long recycled_spawns() const;
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
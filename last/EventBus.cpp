@@ -0,0 +1,15 @@
+#include "EventBus.hpp"
+
+static const char* const event_names[EVENT_COUNT] = {
+    "player_hit", "enemy_killed", "boss_hit", "boss_killed", "enemy_spawned", "boss_spawned"};
+
+static size_t power_of_two(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+    EventBus::EventBus(size_t capacity) : ring(power_of_two(capacity)), mask(ring.size() - 1),
+        head(0), tail(0) {}
+    void EventBus::clear() { head = tail = 0; }
+    const char* EventBus::name(GameEventType type) { return event_names[type]; }
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+enum GameEventType : unsigned char {
+    EVENT_PLAYER_HIT,                   // kind says what hit the player
+    EVENT_ENEMY_KILLED,
+    EVENT_BOSS_HIT,
+    EVENT_BOSS_KILLED,
+    EVENT_ENEMY_SPAWNED,
+    EVENT_BOSS_SPAWNED,
+    EVENT_COUNT
+};
+
+struct GameEvent {
+    GameEventType type;
+    unsigned char kind;                 // EntityKind of the other party
+    int16_t points;                     // score it is worth
+    int32_t x, y;                       // world cell where it happened
+};
+
+// Ring of one tick's gameplay events. Detection pushes them in a fixed order
+// and the game drains the whole batch after the collision phase, so a tick
+// reacts exactly as if the effects had been applied inline. Storage is
+// allocated once; the caller drains early instead of letting it overflow.
+class EventBus {
+    std::vector<GameEvent> ring;
+    size_t mask;
+    size_t head;
+    size_t tail;
+public:
+    explicit EventBus(size_t capacity);
+    bool full() const { return head - tail == ring.size(); }
+    bool empty() const { return head == tail; }
+    size_t size() const { return head - tail; }
+    void push(const GameEvent& ev) { ring[head++ & mask] = ev; }
+    template <typename F>
+    void drain(F&& consume) {
+        while (tail != head) consume(ring[tail++ & mask]);
+    }
+    void clear();
+    static const char* name(GameEventType type);
+};
@@ -0,0 +1,63 @@
+#include "FlowField.hpp"
+#include <algorithm>
+
+    FlowField::FlowField() : area{0, 0, 0, 0}, target_x(-1), target_y(-1), walls_seen(-1),
+        step_x(1, -1), step_y(1, 0), builds(0) {}
+    void FlowField::invalidate() { walls_seen = -1; }
+    // Sizes the buffers for an arena of up to `cells` cells, so building the
+    // field never allocates.
+    void FlowField::reserve(int cells) {
+        dist.reserve(cells);
+        step_x.reserve(cells + 1);
+        step_y.reserve(cells + 1);
+        queue.reserve(cells);
+    }
+    // Rebuilds the field if anything it depends on moved; returns whether it did.
+    bool FlowField::update(const World& world, int tx, int ty) {
+        const Rect& a = world.active;
+        if (a.x0 == area.x0 && a.y0 == area.y0 && a.x1 == area.x1 && a.y1 == area.y1
+            && tx == target_x && ty == target_y && world.wall_version == walls_seen)
+            return false;
+        area = a;
+        target_x = tx;
+        target_y = ty;
+        walls_seen = world.wall_version;
+        builds++;
+        const int w = area.width(), h = area.height(), n = w * h;
+        dist.assign(n, uint16_t(UNREACHABLE));
+        step_x.assign(n + 1, 0);
+        step_y.assign(n + 1, 0);
+        step_x[n] = -1;
+        queue.resize(n);
+        // The world's top row is under the HUD, when the arena reaches it;
+        // walls are stamped in as already visited so the search never enters
+        // them.
+        if (area.y0 == 0)
+            for (int x = 0; x < w; x++) dist[x] = UNREACHABLE - 1;
+        for (const Rect& r : world.walls)
+            for (int y = std::max(r.y0, area.y0); y < std::min(r.y1, area.y1); y++)
+                for (int x = std::max(r.x0, area.x0); x < std::min(r.x1, area.x1); x++)
+                    dist[index(x, y)] = UNREACHABLE - 1;
+        if (!area.contains(tx, ty) || dist[index(tx, ty)] != UNREACHABLE) return true;
+        size_t head = 0, tail = 0;
+        dist[index(tx, ty)] = 0;
+        queue[tail++] = index(tx, ty);
+        while (head < tail) {
+            int c = queue[head++];
+            int cx = c % w, cy = c / w;
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++) {
+                    int nx = cx + dx, ny = cy + dy;
+                    if ((!dx && !dy) || nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                    int nc = ny * w + nx;
+                    if (dist[nc] != UNREACHABLE) continue;
+                    dist[nc] = dist[c] + 1;
+                    step_x[nc] = -dx;
+                    step_y[nc] = -dy;
+                    queue[tail++] = nc;
+                }
+        }
+        for (int c = 0; c < n; c++)
+            if (dist[c] == UNREACHABLE - 1) dist[c] = UNREACHABLE;
+        return true;
+    }
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "World.hpp"
+
+// Shared pursuit field over the active arena: BFS distance to the player
+// through the 8-neighbourhood, avoiding walls, with each cell's step toward
+// the player stored next to it. One build serves every enemy, which then
+// reads its next move in O(1). The field is only rebuilt when the player's
+// cell, the arena or the walls change, and then in full: one player step can
+// shift the distance of every cell, and the arena is at most WIDTH x HEIGHT,
+// so a repair would touch about as much as the BFS (the bench reports the
+// cost per build and per enemy). Cells outside the arena read as a plain
+// leftward drift.
+class FlowField {
+    Rect area;
+    int target_x, target_y;
+    long walls_seen;
+    std::vector<uint16_t> dist;
+    std::vector<signed char> step_x;    // one extra cell past the end: outside
+    std::vector<signed char> step_y;
+    std::vector<int> queue;
+    long builds;
+public:
+    static const uint16_t UNREACHABLE = 0xffff;
+
+    FlowField();
+    void reserve(int cells);
+    bool update(const World& world, int tx, int ty);
+    void invalidate();
+    int index(int x, int y) const {
+        return area.contains(x, y) ? (y - area.y0) * area.width() + (x - area.x0) : int(dist.size());
+    }
+    int dx(int cell) const { return step_x[cell]; }
+    int dy(int cell) const { return step_y[cell]; }
+    uint16_t distance(int x, int y) const {
+        return area.contains(x, y) ? dist[index(x, y)] : UNREACHABLE;
+    }
+    long build_count() const { return builds; }
+};
@@ -0,0 +1,64 @@
+#include "FrameBuffer.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+    FrameBuffer::FrameBuffer(int w, int h) : width(w), height(h),
+        background(w * h, GlyphId(' ')), back(w * h), front(w * h),
+        front_valid(false), written(0) {}
+    void FrameBuffer::resize(int w, int h) {
+        width = w;
+        height = h;
+        background.assign(w * h, GlyphId(' '));
+        back.assign(w * h, GlyphId(' '));
+        front.assign(w * h, GlyphId(' '));
+        front_valid = false;
+    }
+    void FrameBuffer::set_background(int x, int y, GlyphId g) {
+        if (x >= 0 && x < width && y >= 0 && y < height) background[y * width + x] = g;
+    }
+    void FrameBuffer::begin() { back = background; }
+    // Single-column glyphs only; anything wider goes through a sprite.
+    void FrameBuffer::put(int x, int y, GlyphId g) {
+        if (x >= 0 && x < width && y >= 0 && y < height) back[y * width + x] = g;
+    }
+    // Copies a sprite row by row, clipped to the buffer. A wide glyph cut
+    // off at the right edge is dropped rather than left without its tail.
+    void FrameBuffer::blit(int x, int y, SpriteId id) {
+        const Atlas& atlas = Atlas::shared();
+        const Sprite& s = atlas.sprite(id);
+        int from = std::max(0, -x), to = std::min<int>(s.width, width - x);
+        if (from >= to) return;
+        for (int r = std::max(0, -y); r < s.height && y + r < height; r++) {
+            // Offsets start at the first visible column, which is never left
+            // of the buffer, so no pointer is formed outside it.
+            const GlyphId* row = atlas.row(id, r) + from;
+            const int at = (y + r) * width + x + from, n = to - from;
+            GlyphId* out = &back[at];
+            memcpy(out, row, n * sizeof(GlyphId));
+            if (to < s.width && row[n] == Atlas::WIDE_TAIL) out[n - 1] = background[at + n - 1];
+            if (from > 0 && row[0] == Atlas::WIDE_TAIL) out[0] = background[at];
+        }
+    }
+    void FrameBuffer::text(int x, int y, const char* fmt, ...) {
+        char buf[256];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        for (int i = 0; buf[i] && x + i < width; i++) put(x + i, y, static_cast<unsigned char>(buf[i]) & 0x7f);
+    }
+    int FrameBuffer::get_width() const { return width; }
+    int FrameBuffer::get_height() const { return height; }
+    GlyphId FrameBuffer::at(int x, int y) const { return back[y * width + x]; }
+    bool FrameBuffer::dirty(int x, int y) const {
+        return !front_valid || back[y * width + x] != front[y * width + x];
+    }
+    void FrameBuffer::flip(long cells) {
+        front.swap(back);
+        front_valid = true;
+        written = cells;
+    }
+    void FrameBuffer::invalidate() { front_valid = false; }
+    long FrameBuffer::cells_written() const { return written; }
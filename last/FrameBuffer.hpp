@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+#include "Atlas.hpp"
+
+// Game-owned back and front cell buffers of atlas glyph IDs. Each frame
+// starts from a static background layer; a Renderer emits only the cells
+// that differ from what is already on its output, then calls flip().
+class FrameBuffer {
+    int width, height;
+    std::vector<GlyphId> background;
+    std::vector<GlyphId> back;
+    std::vector<GlyphId> front;
+    bool front_valid;
+    long written;
+public:
+    FrameBuffer(int w, int h);
+    void resize(int w, int h);
+    void set_background(int x, int y, GlyphId g);
+    void begin();
+    void put(int x, int y, GlyphId g);
+    void blit(int x, int y, SpriteId id);
+    void text(int x, int y, const char* fmt, ...);
+    int get_width() const;
+    int get_height() const;
+    GlyphId at(int x, int y) const;
+    bool dirty(int x, int y) const;
+    void flip(long cells);
+    void invalidate();
+    long cells_written() const;
+};
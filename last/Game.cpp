@@ -1,151 +1,728 @@
 #include "Game.hpp"
 #include "Constants.hpp"
 #include "Boss.hpp"
-#include <ncursesw/ncurses.h>
+#include "Sweep.hpp"
 #include <cstdlib>
-#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
 #include <thread>
 #include <chrono>
 #include <algorithm>
 
-    Game::Game() : player(5, HEIGHT / 2), score(0), game_over(false) {
-        setlocale(LC_ALL, "");
-        srand(time(nullptr));
-        initscr();
-        cbreak();
-        noecho();
-        keypad(stdscr, TRUE);
-        nodelay(stdscr, TRUE);
-        curs_set(0);
-        start_time = std::chrono::steady_clock::now();
+    Game::Game(Renderer& renderer_, const GameConfig& config_) : renderer(renderer_), config(config_),
+        player(5, config_.world_height / 2, config_.world_width, config_.world_height),
+        player_ox(player.get_x()), player_oy(player.get_y()),
+        bullets(config_.bullet_capacity, POOL_RECYCLE_OLDEST),
+        enemies(config_.enemy_capacity, POOL_DROP),
+        bosses(config_.boss_capacity, POOL_GROW),
+        score(0), game_over(false), ticks(0),
+        world(config_.world_width, config_.world_height), cam_x(0), cam_y(0),
+        enemy_grid(config_.world_width, config_.world_height, config_.enemy_capacity * 4),
+        boss_grid(config_.world_width, config_.world_height,
+            config_.boss_capacity * (Boss::width + 1) * (Boss::height + 1)),
+        screen(WIDTH, HEIGHT),
+        spawn_rng(config_.seed, RNG_SPAWN), move_rng(config_.seed, RNG_ENEMY_MOVE),
+        fire_rng(config_.seed, RNG_ENEMY_FIRE), boss_rng(config_.seed, RNG_BOSS),
+        move_rolls(config_.enemy_capacity), fire_rolls(config_.enemy_capacity),
+        shoot(config_.enemy_capacity), contact(config_.bullet_capacity),
+        events(config_.bullet_capacity + config_.enemy_capacity + config_.boss_capacity), jobs(config_.threads),
+        history(config_.rewind_seconds, FPS),
+        bullets_buf(config_.bullet_capacity, POOL_RECYCLE_OLDEST),
+        enemies_buf(config_.enemy_capacity, POOL_DROP),
+        bosses_buf(config_.boss_capacity, POOL_GROW),
+        recorder(nullptr), replay(nullptr), undisplayed_stamp(0), last_key(KEY_NONE) {
+        candidates.reserve(config.enemy_capacity * 4);
+        walls_buf.reserve(World::MAX_WALLS);
+        // follow_player() clamps the arena to a WIDTH x HEIGHT window of the world.
+        field.reserve(std::min(WIDTH, config.world_width) * std::min(HEIGHT, config.world_height));
+        memset(messages, 0, sizeof(messages));
+        if (!config.level_path.empty()) waves.open(config.level_path.c_str());
+        resize_view();
     }
     
     Game::~Game() {
         cleanup();
-        endwin();
     }
 
     void Game::run() {
+        if (renderer.realtime()) run_realtime();
+        else run_headless();
+        ALLOC_TICK(-1);
+        if (recorder) recorder->finish(ticks, state_hash());
+        renderer.game_over(score);
+    }
+
+    static int64_t stamp(std::chrono::steady_clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+
+    void Game::run_realtime() {
+        using clock = std::chrono::steady_clock;
+        const clock::duration tick_len = std::chrono::duration_cast<clock::duration>(std::chrono::seconds(1)) / FPS;
+        const clock::duration frame_len = std::chrono::duration_cast<clock::duration>(std::chrono::seconds(1)) / RENDER_FPS;
+        clock::time_point previous = clock::now();
+        clock::time_point next_render = previous;
+        clock::duration accumulator = tick_len;
+        int keys[MAX_KEYS_PER_TICK];
         while (!game_over) {
-            int input = getch();
-            handle_input(input);
-            update(input);
-            render(input);
+            PROFILE_FRAME(profiler);
+            clock::time_point now = clock::now();
+            accumulator += now - previous;
+            previous = now;
+            for (int key = renderer.read_key(); key != KEY_NONE; key = renderer.read_key()) queue_key(key);
+            stats.sim_ticks = 0;
+            while (accumulator >= tick_len && stats.sim_ticks < MAX_CATCHUP_TICKS && !game_over) {
+                accumulator -= tick_len;
+                // Keys go to the tick whose interval they arrived in; the
+                // last tick of the frame takes everything still queued.
+                bool last = accumulator < tick_len || stats.sim_ticks + 1 == MAX_CATCHUP_TICKS;
+                int count = take_input(stamp(last ? now : now - accumulator), keys);
+                tick(keys, count);
+                stats.sim_ticks++;
+            }
+            if (accumulator >= tick_len) {
+                stats.dropped_ticks += accumulator / tick_len;
+                accumulator %= tick_len;
+            }
+            if (now >= next_render) {
+                render();
+                stats.rendered++;
+                if (undisplayed_stamp) {
+                    long latency = (stamp(clock::now()) - undisplayed_stamp) / 1000;
+                    stats.input_latency_us = latency;
+                    stats.input_latency_max_us = std::max(stats.input_latency_max_us, latency);
+                    stats.input_latency_sum_us += latency;
+                    stats.input_latency_samples++;
+                    undisplayed_stamp = 0;
+                }
+                next_render += frame_len;
+                if (next_render <= now) next_render = now + frame_len;
+            }
+            stats.frames++;
+            clock::time_point wake = std::min(previous + (tick_len - accumulator), next_render);
+            clock::duration slack = wake - clock::now();
+            stats.slack_us = std::chrono::duration_cast<std::chrono::microseconds>(slack).count();
+            if (slack.count() < 0) {
+                stats.overruns++;
+                continue;
+            }
+            // Sleep inside the renderer's key wait so keys are stamped when they arrive.
+            PROFILE_SCOPE(profiler, ZONE_SLEEP);
+            for (clock::duration left = slack; left.count() > 0; left = wake - clock::now()) {
+                int ms = std::chrono::duration_cast<std::chrono::milliseconds>(left).count();
+                if (ms == 0) {
+                    std::this_thread::sleep_until(wake);
+                    break;
+                }
+                int key = renderer.wait_key(ms);
+                if (key != KEY_NONE) queue_key(key);
+            }
+        }
+    }
+
+    void Game::queue_key(int key) {
+        if (key == KEY_RESIZE) {
+            resize_view();
+            return;
+        }
+        input.push(InputEvent{key, stamp(std::chrono::steady_clock::now())});
+        stats.input_events++;
+    }
+
+    // Only the framebuffer follows the terminal; the world keeps its size.
+    void Game::resize_view() {
+        int w, h;
+        renderer.viewport(w, h);
+        screen.resize(std::max(w, 1), std::max(h, 1));
+        const GlyphId dot = Atlas::shared().row(SPRITE_DOT, 0)[0];
+        for (int y = 1; y < std::min(h, world.height); y++)
+            for (int x = 0; x < std::min(w, world.width); x++)
+                screen.set_background(x, y, dot);
+    }
+
+    static int clamp_axis(int v, int view, int size) {
+        return std::max(0, std::min(v, size - view));
+    }
+
+    // The simulated region is a WIDTH x HEIGHT window placed like the default
+    // camera, independent of the terminal, so replays do not depend on it.
+    void Game::follow_player() {
+        int ax = clamp_axis(player.get_x() - WIDTH / 4, WIDTH, world.width);
+        int ay = clamp_axis(player.get_y() - HEIGHT / 2, HEIGHT, world.height);
+        world.plan(Rect{ax, ay, std::min(ax + WIDTH, world.width), std::min(ay + HEIGHT, world.height)}, ticks);
+    }
+
+    int Game::take_input(int64_t until_ns, int* keys) {
+        int count = 0;
+        InputEvent ev;
+        while (count < MAX_KEYS_PER_TICK && input.peek(ev) && ev.stamp_ns <= until_ns) {
+            input.pop(ev);
+            keys[count++] = ev.key;
+            if (!undisplayed_stamp) undisplayed_stamp = ev.stamp_ns;
+        }
+        return count;
+    }
+
+    void Game::run_headless() {
+        while (!game_over && (config.max_ticks == 0 || ticks < config.max_ticks)) {
+            step(renderer.read_key());
+            PROFILE_FRAME(profiler);
+            stats.sim_ticks = 1;
+            stats.frames++;
+            stats.rendered++;
+        }
+    }
+
+    void Game::tick(int input) {
+        tick(&input, input == KEY_NONE ? 0 : 1);
+    }
+
+    void Game::tick(const int* keys, int count) {
+        ALLOC_TICK(ticks);
+        int replayed[MAX_KEYS_PER_TICK];
+        if (replay) {
+            for (int i = 0; i < count; i++)
+                if (keys[i] == 'q') game_over = true;
+            count = 0;
+            for (int key = replay->next_key(ticks); key != KEY_NONE && count < MAX_KEYS_PER_TICK;
+                key = replay->next_key(ticks))
+                replayed[count++] = key;
+            keys = replayed;
+        }
+        if (recorder)
+            for (int i = 0; i < count; i++) recorder->record(ticks, keys[i]);
+        // Rewinding is live play only: a recording's ticks must stay monotonic.
+        if (history.enabled() && !recorder && !replay)
+            for (int i = 0; i < count; i++)
+                if (keys[i] == 'r') {
+                    rewind(FPS);
+                    return;
+                }
+        last_key = count ? keys[count - 1] : KEY_NONE;
+        if (config.time_phases) {
+            using clock = std::chrono::steady_clock;
+            clock::time_point t0 = clock::now();
+            for (int i = 0; i < count; i++) handle_input(keys[i]);
+            clock::time_point t1 = clock::now();
+            update(keys, count);
+            clock::time_point t2 = clock::now();
+            check_collisions();
+            dispatch_events();
+            clock::time_point t3 = clock::now();
+            phases.input_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+            phases.update_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+            phases.collide_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count();
+        } else {
+            for (int i = 0; i < count; i++) handle_input(keys[i]);
+            update(keys, count);
             check_collisions();
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000 / FPS));
+            dispatch_events();
+        }
+        ticks++;
+        PROFILE_SET(profiler, COUNTER_BULLETS, bullets.size());
+        PROFILE_SET(profiler, COUNTER_ENEMIES, enemies.size());
+        PROFILE_SET(profiler, COUNTER_BOSSES, bosses.size());
+        ALLOC_POOL(ALLOC_BULLETS, bullets);
+        ALLOC_POOL(ALLOC_ENEMIES, enemies);
+        ALLOC_POOL(ALLOC_BOSSES, bosses);
+        stats.allocations = bullets.allocations() + enemies.allocations() + bosses.allocations()
+            + enemy_grid.allocations() + boss_grid.allocations();
+        if (history.enabled()) {
+            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+            save_state(state_buf);
+            history.push(ticks, state_buf);
+            stats.rewind_bytes = history.memory_bytes();
+            if (config.time_phases)
+                phases.snapshot_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - t0).count();
+        }
+    }
+
+    void Game::step(int input) {
+        tick(input);
+        if (config.time_phases) {
+            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+            render();
+            phases.render_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+        } else {
+            render();
+        }
+    }
+
+    void Game::fast_forward(long tick_) {
+        while (!game_over && ticks < tick_) tick(KEY_NONE);
+    }
+
+    // Starts over with a new seed in place: pools, grids and buffers are
+    // emptied but kept, so a finished game can be reused without allocating.
+    void Game::reset(unsigned seed) {
+        config.seed = seed;
+        cleanup();
+        score = 0;
+        game_over = false;
+        ticks = 0;
+        last_key = KEY_NONE;
+        player.restore(5, config.world_height / 2, PLAYER_LIVES);
+        walls_buf.clear();
+        world.set_walls(walls_buf);
+        memset(messages, 0, sizeof(messages));
+        events.clear();
+        spawn_rng.seed(seed, RNG_SPAWN);
+        move_rng.seed(seed, RNG_ENEMY_MOVE);
+        fire_rng.seed(seed, RNG_ENEMY_FIRE);
+        boss_rng.seed(seed, RNG_BOSS);
+        waves.restart();
+        history.truncate_after(-1);
+    }
+
+    void Game::record_to(Recording& log) {
+        recorder = &log;
+        recorder->begin(config);
+    }
+
+    void Game::replay_from(Recording& log) {
+        replay = &log;
+        replay->rewind();
+    }
+
+    uint64_t Game::state_hash() const {
+        uint64_t h = 14695981039346656037ULL;
+        const int64_t fields[3] = {score, player.get_lives(), ticks};
+        for (int64_t f : fields)
+            for (int i = 0; i < 8; i++) {
+                h ^= uint8_t(f >> (i * 8));
+                h *= 1099511628211ULL;
+            }
+        return h;
+    }
+
+    void Game::save_state(std::vector<uint8_t>& out) const {
+        SnapshotWriter w(out);
+        SnapshotHeader h;
+        memset(&h, 0, sizeof(h));       // padding too: equal states save equal bytes
+        memcpy(h.magic, "SHMS", 4);
+        h.version = Snapshot::VERSION;
+        h.seed = config.seed;
+        h.world_width = world.width;
+        h.world_height = world.height;
+        h.bullet_capacity = config.bullet_capacity;
+        h.enemy_capacity = config.enemy_capacity;
+        h.boss_capacity = config.boss_capacity;
+        h.ticks = ticks;
+        config.level_path.copy(h.level, sizeof(h.level) - 1);
+        w.put(h);
+        w.put(int64_t(score));
+        w.put(int32_t(game_over));
+        w.put(int32_t(last_key));
+        w.put(int32_t(player.get_x()));
+        w.put(int32_t(player.get_y()));
+        w.put(int32_t(player.get_lives()));
+        for (const Rng* r : {&spawn_rng, &move_rng, &fire_rng, &boss_rng}) {
+            w.put(r->raw_state());
+            w.put(r->raw_stream());
+        }
+        w.put_bytes(messages, sizeof(messages));
+        w.put(uint32_t(world.walls.size()));
+        w.put_array(world.walls, World::MAX_WALLS);
+        bullets.save(w);
+        enemies.save(w);
+        bosses.save(w);
+        waves.save(w);
+        uint32_t bytes = w.size();
+        memcpy(w.at(offsetof(SnapshotHeader, bytes)), &bytes, sizeof(bytes));
+    }
+
+    // Restores a snapshot taken from a game with the same world size. Nothing
+    // changes unless the whole snapshot decodes: the pools are read into the
+    // spare stores and swapped in, and the wave schedule, read last, puts its
+    // own position back when it fails.
+    bool Game::load_state(const uint8_t* data, size_t len) {
+        SnapshotHeader h;
+        if (!Snapshot::header(data, len, h) || h.world_width != world.width || h.world_height != world.height)
+            return false;
+        SnapshotReader r(data, len);
+        r.get(h);
+        int64_t score_ = 0;
+        int32_t over = 0, key = 0, px = 0, py = 0, lives = 0;
+        uint64_t rng_state[4][2] = {};
+        HudMessage shown[MESSAGE_LINES];
+        r.get(score_);
+        r.get(over);
+        r.get(key);
+        r.get(px);
+        r.get(py);
+        r.get(lives);
+        for (auto& s : rng_state) {
+            r.get(s[0]);
+            r.get(s[1]);
         }
-        clear();
-        mvprintw(HEIGHT / 2, WIDTH / 2 - 5, "Game Over! Score: %d", score);
-        refresh();
-        std::this_thread::sleep_for(std::chrono::seconds(3));
+        r.get_bytes(shown, sizeof(shown));
+        uint32_t wall_count = 0;
+        r.get(wall_count);
+        r.get_array(walls_buf, wall_count, World::MAX_WALLS);
+        if (px < 0 || px >= world.width || py < 0 || py >= world.height) return false;
+        if (!r.ok() || !bullets_buf.load(r) || !enemies_buf.load(r) || !bosses_buf.load(r) || !waves.load(r))
+            return false;
+        std::swap(bullets, bullets_buf);
+        std::swap(enemies, enemies_buf);
+        std::swap(bosses, bosses_buf);
+        memcpy(messages, shown, sizeof(messages));
+        config.seed = h.seed;
+        ticks = h.ticks;
+        score = score_;
+        game_over = over;
+        last_key = key;
+        player.restore(px, py, lives);
+        world.set_walls(walls_buf);
+        Rng* rngs[4] = {&spawn_rng, &move_rng, &fire_rng, &boss_rng};
+        for (int i = 0; i < 4; i++) rngs[i]->restore(rng_state[i][0], rng_state[i][1]);
+        return true;
     }
 
+    // Steps back up to `back` ticks, clamped to the oldest kept snapshot.
+    bool Game::rewind(long back) {
+        int64_t target = std::max<int64_t>(ticks - back, history.oldest_tick());
+        const std::vector<uint8_t>* state = history.seek(target);
+        if (!state || !load_state(state->data(), state->size())) return false;
+        history.truncate_after(target);
+        return true;
+    }
+
+    bool Game::profile_to([[maybe_unused]] const char* path) {
+#ifdef SHMUP_PROFILE
+        return profiler.open(path);
+#else
+        return false;
+#endif
+    }
+
+    const LoopStats& Game::loop_stats() const { return stats; }
+    const PhaseTimes& Game::phase_times() const { return phases; }
+
     void Game::cleanup() {
         bullets.clear();
-        bullets.shrink_to_fit();
         enemies.clear();
-        enemies.shrink_to_fit();
         bosses.clear();
-        bosses.shrink_to_fit();
     }
 
     void Game::handle_input(int input) {
+        PROFILE_SCOPE(profiler, ZONE_INPUT);
+        ALLOC_PHASE(ALLOC_INPUT);
         if (input == ' ') {
-            bullets.emplace_back(player.get_x() + 1, player.get_y(), true);
+            Bullet::spawn(bullets, player.get_x() + 1, player.get_y(), true);
         } else if (input == 'q') {
             game_over = true;
         }
+#ifdef SHMUP_PROFILE
+        if (input == 'p') profiler.toggle_overlay();
+#endif
     }
 
-    void Game::update(int input) {
-        if (rand() % 100 < 15) {
-            bool scripted = (score >= 20 && rand() % 2);
-            enemies.emplace_back(WIDTH - 1, rand() % (HEIGHT - 2) + 1, scripted);
+    void Game::spawn_wave(const WaveEntry& e) {
+        const Rect& arena = world.active;
+        if (e.kind == WAVE_BOSS) {
+            const int bx = arena.x1 - 2, by = (arena.y0 + arena.y1) / 2;
+            if (Boss::spawn(bosses, bx, by).valid()) emit(EVENT_BOSS_SPAWNED, KIND_BOSS, bx, by, BOSS_SPAWN_SCORE);
+            return;
         }
-        if (score >= BOSS_SCORE_THRESHOLD && bosses.empty()) {
-            bosses.emplace_back(WIDTH - 2, HEIGHT / 2);
-            score += 10;
+        int x = std::max(arena.x0, arena.x1 - 1 - e.depth);
+        if (e.kind == WAVE_WALL) {
+            int y = arena.y0 + 1 + e.lane % (arena.height() - 2);
+            world.add_wall(Rect{x, y, x + e.width, std::min(y + e.height, arena.y1)});
+            return;
         }
-        player.update(input);
-        for (auto& bullet : bullets) bullet.update(input);
-        for (auto& enemy : enemies) {
-            enemy.update(input);
-            if (enemy.is_active() && enemy.can_shoot()) {
-                bullets.emplace_back(enemy.get_x() - 1, enemy.get_y(), false);
+        int y = arena.y0 + 1 + e.lane % (arena.height() - 2);
+        if (Enemy::spawn(enemies, x, y, e.move, e.fire).valid()) emit(EVENT_ENEMY_SPAWNED, KIND_SCRIPTED_ENEMY, x, y);
+    }
+
+    void Game::update(const int* keys, int count) {
+        PROFILE_SCOPE(profiler, ZONE_UPDATE);
+        ALLOC_PHASE(ALLOC_UPDATE);
+        follow_player();
+        const Rect& arena = world.active;
+        if (waves.loaded()) {
+            waves.take(ticks, [this](const WaveEntry& e) { spawn_wave(e); });
+        } else {
+            uint32_t spawn[3];
+            spawn_rng.fill_below(spawn, 2, 100);
+            spawn[2] = spawn_rng.below(arena.height() - 2);
+            if (spawn[0] < 15) {
+                bool scripted = (score >= 20 && spawn[1] % 2);
+                int x = arena.x1 - 1, y = arena.y0 + spawn[2] + 1;
+                if (Enemy::spawn(enemies, x, y, scripted).valid())
+                    emit(EVENT_ENEMY_SPAWNED, scripted ? KIND_SCRIPTED_ENEMY : KIND_ENEMY, x, y);
             }
-        }
-        for (auto& boss : bosses) boss.update(input);
-        bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
-            [](const Bullet& b) { return !b.is_active(); }), bullets.end());
-        enemies.erase(std::remove_if(enemies.begin(), enemies.end(),
-            [](const Enemy& e) { return !e.is_active(); }), enemies.end());
-        bosses.erase(std::remove_if(bosses.begin(), bosses.end(),
-            [](const Boss& b) { return !b.is_active(); }), bosses.end());
-    }
-
-    void Game::render(int input) {
-        clear();
-        for (int y = 1; y < HEIGHT; y++)
-            for (int x = 0; x < WIDTH; x++) {
-                cchar_t dot;
-                setcchar(&dot, L".", 0, 0, nullptr);
-                mvadd_wch(y, x, &dot);
+            if (score >= BOSS_SCORE_THRESHOLD && bosses.empty()) {
+                int x = arena.x1 - 2, y = (arena.y0 + arena.y1) / 2;
+                if (Boss::spawn(bosses, x, y).valid()) emit(EVENT_BOSS_SPAWNED, KIND_BOSS, x, y, BOSS_SPAWN_SCORE);
             }
-        player.render();
-        for (const auto& bullet : bullets) bullet.render();
-        for (const auto& enemy : enemies) enemy.render();
-        for (const auto& boss : bosses) boss.render();
-        auto now = std::chrono::steady_clock::now();
-        int time = std::chrono::duration_cast<std::chrono::seconds>(now - start_time).count();
-        mvprintw(0, 0, "Score: %d | Lives: %d | Time: %d", score, player.get_lives(), time);
-        mvprintw(0, WIDTH - 20, "Key: %d", input);
+        }
+        player_ox = player.get_x();
+        player_oy = player.get_y();
+        for (int i = 0; i < count; i++) player.update(keys[i]);
+        if (config.time_phases) {
+            auto t0 = std::chrono::steady_clock::now();
+            if (Enemy::pursuing(enemies)) field.update(world, player.get_x(), player.get_y());
+            phases.flow_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+        } else if (Enemy::pursuing(enemies)) {
+            field.update(world, player.get_x(), player.get_y());
+        }
+        auto move_bullets = [this](size_t b, size_t e) { Bullet::update(bullets, world, b, e); };
+        jobs.parallel_for(bullets.size(), BULLET_GRAIN, move_bullets);
+        if (move_rolls.size() < enemies.size()) {
+            move_rolls.resize(enemies.capacity());
+            fire_rolls.resize(enemies.capacity());
+            shoot.resize(enemies.capacity());
+        }
+        move_rng.fill_below(move_rolls.data(), enemies.size(), 10);
+        fire_rng.fill_below(fire_rolls.data(), enemies.size(), 100);
+        auto move_enemies = [this](size_t b, size_t e) {
+            Enemy::update(enemies, world, field, move_rolls.data(), fire_rolls.data(), shoot.data(), b, e);
+        };
+        jobs.parallel_for(enemies.size(), ENEMY_GRAIN, move_enemies);
+        Enemy::fire(enemies, bullets, shoot.data(), player.get_x(), player.get_y());
+        Boss::update(bosses, world, boss_rng);
+        Boss::fire(bosses, bullets, ticks, player.get_x(), player.get_y());
+        bullets.compact();
+        enemies.compact();
+        bosses.compact();
+    }
+
+    void Game::render() {
+        PROFILE_SCOPE(profiler, ZONE_RENDER);
+        ALLOC_PHASE(ALLOC_RENDER);
+        const int view_w = screen.get_width(), view_h = screen.get_height();
+        cam_x = clamp_axis(player.get_x() - view_w / 4, view_w, world.width);
+        cam_y = clamp_axis(player.get_y() - view_h / 2, view_h, world.height);
+        screen.begin();
+        const GlyphId wall = Atlas::shared().row(SPRITE_WALL, 0)[0];
+        for (const Rect& r : world.walls)
+            for (int y = std::max(r.y0, cam_y); y < std::min(r.y1, cam_y + view_h); y++)
+                for (int x = std::max(r.x0, cam_x); x < std::min(r.x1, cam_x + view_w); x++)
+                    screen.put(x - cam_x, y - cam_y, wall);
+        player.render(screen, cam_x, cam_y);
+        Bullet::render(bullets, screen, cam_x, cam_y);
+        Enemy::render(enemies, screen, cam_x, cam_y);
+        Boss::render(bosses, screen, cam_x, cam_y);
+        // Game time, not wall time, so it follows rewinds and stays out of snapshots.
+        screen.text(0, 0, "Score: %d | Lives: %d | Time: %ld", score, player.get_lives(), ticks / FPS);
+        screen.text(view_w - 20, 0, "Key: %d", last_key);
         int player_bullets = 0;
-        for (const auto& bullet : bullets) if (bullet.is_from_player()) player_bullets++;
-        mvprintw(1, WIDTH - 20, "Bullets: %d", player_bullets);
-        refresh();
+        for (size_t i = 0; i < bullets.size(); i++) if (Bullet::is_from_player(bullets, i)) player_bullets++;
+        screen.text(view_w - 20, 1, "Bullets: %d", player_bullets);
+        screen.text(view_w - 20, 2, "Ticks: %d Over: %ld", stats.sim_ticks, stats.overruns);
+        screen.text(view_w - 20, 3, "Slack: %ldus", stats.slack_us);
+        screen.text(view_w - 20, 4, "Cells: %ld", stats.cells_written);
+        screen.text(view_w - 20, 5, "Input: %ldus", stats.input_latency_us);
+        if (history.enabled()) screen.text(view_w - 20, 6, "Rewind: %ldKB", stats.rewind_bytes / 1024);
+        if (renderer.realtime()) screen.text(view_w - 20, 7, "Out: %ldB %ldw", stats.output_bytes, stats.output_writes);
+#ifdef SHMUP_DEBUG
+        screen.text(view_w - 20, 8, "Allocs: %ld", stats.allocations);
+#endif
+        for (int i = 0; i < MESSAGE_LINES; i++)
+            if (ticks < messages[i].until) screen.text(0, i + 1, "%s", messages[i].text);
+#ifdef SHMUP_PROFILE
+        profiler.draw(screen, view_w - 48, 0);
+#endif
+        {
+            PROFILE_SCOPE(profiler, ZONE_REFRESH);
+            renderer.present(screen);
+        }
+        stats.cells_written = screen.cells_written();
+        OutputStats out = renderer.output();
+        stats.output_bytes = out.bytes - output_seen.bytes;
+        stats.output_writes = out.writes - output_seen.writes;
+        output_seen = out;
+        PROFILE_SET(profiler, COUNTER_CELLS, stats.cells_written);
+    }
+
+    static SweptBox swept(const EntityStore& store, size_t i, int w, int h) {
+        return SweptBox{store.ox[i], store.oy[i], store.fx[i], store.fy[i], w * FIX_ONE, h * FIX_ONE};
+    }
+
+    // Inclusive range of cells a swept box passes through during the tick.
+    struct CellRange {
+        int x0, y0, x1, y1;
+    };
+
+    static CellRange cells_of(const SweptBox& b) {
+        return CellRange{std::min(b.x0, b.x1) >> FIX_SHIFT, std::min(b.y0, b.y1) >> FIX_SHIFT,
+            (std::max(b.x0, b.x1) + b.w - 1) >> FIX_SHIFT, (std::max(b.y0, b.y1) + b.h - 1) >> FIX_SHIFT};
+    }
+
+    template <typename F>
+    static void for_cells(const SpatialGrid& grid, const CellRange& r, F fn) {
+        for (int y = r.y0; y <= r.y1; y++)
+            for (int x = r.x0; x <= r.x1; x++) grid.for_each(x, y, fn);
+    }
+
+    // Each entity is filed under every cell its box swept this tick, so any
+    // two paths that cross share at least one cell.
+    void Game::build_grids() {
+        enemy_grid.clear();
+        for (size_t i = 0; i < enemies.size(); i++) {
+            if (!enemies.alive[i]) continue;
+            CellRange r = cells_of(swept(enemies, i, 1, 1));
+            for (int y = r.y0; y <= r.y1; y++)
+                for (int x = r.x0; x <= r.x1; x++) enemy_grid.insert(x, y, i);
+        }
+        enemy_grid.build();
+        boss_grid.clear();
+        for (size_t i = 0; i < bosses.size(); i++) {
+            if (!bosses.alive[i]) continue;
+            CellRange r = cells_of(swept(bosses, i, Boss::width, Boss::height));
+            for (int y = r.y0; y <= r.y1; y++)
+                for (int x = r.x0; x <= r.x1; x++) boss_grid.insert(x, y, i);
+        }
+        boss_grid.build();
     }
 
     void Game::check_collisions() {
-        for (auto& enemy : enemies) {
-            if (enemy.is_active() && enemy.get_x() == player.get_x() && enemy.get_y() == player.get_y()) {
-                player.take_damage();
-                if (player.get_lives() <= 0) game_over = true;
+        PROFILE_SCOPE(profiler, ZONE_COLLIDE);
+        ALLOC_PHASE(ALLOC_COLLIDE);
+        build_grids();
+        int px = player.get_x(), py = player.get_y();
+        // The player sweeps from where it started the tick, so stepping onto a
+        // body that stood still is an entry like any other.
+        const SweptBox me{player_ox * FIX_ONE, player_oy * FIX_ONE, px * FIX_ONE, py * FIX_ONE, FIX_ONE, FIX_ONE};
+        const CellRange reach = cells_of(me);
+        auto collect = [this](int id) { candidates.push_back(id); };
+        candidates.clear();
+        for_cells(enemy_grid, reach, collect);
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        for (int e : candidates)
+            if (enemies.alive[e] && swept_enter(me, swept(enemies, e, 1, 1)))
+                emit(EVENT_PLAYER_HIT, enemies.kind[e], px, py);
+        candidates.clear();
+        for_cells(boss_grid, reach, collect);
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        for (int b : candidates)
+            if (bosses.alive[b] && swept_enter(me, swept(bosses, b, Boss::width, Boss::height)))
+                emit(EVENT_PLAYER_HIT, KIND_BOSS, px, py);
+        // Detection runs in parallel chunks and only marks which bullets touch
+        // something; the hits are then resolved and their events emitted in
+        // bullet order, exactly as a single sequential sweep would.
+        const size_t n = bullets.size();
+        if (contact.size() < n) contact.resize(bullets.capacity());
+        auto probe = [this](size_t b, size_t e) { probe_contacts(b, e); };
+        jobs.parallel_for(n, BULLET_GRAIN, probe);
+        PROFILE_COUNT(profiler, COUNTER_COLLISION_TESTS, n + 2);
+        const unsigned char* kinds = bullets.kind.data();
+        unsigned char* alive = bullets.alive.data();
+        for (size_t i = 0; i < n; i++) {
+            if (contact[i] && kinds[i] == KIND_ENEMY_BULLET) {
+                alive[i] = 0;
+                emit(EVENT_PLAYER_HIT, KIND_ENEMY_BULLET, px, py);
             }
         }
-        for (auto& boss : bosses) {
-            if (boss.is_active() && boss.collides(player.get_x(), player.get_y())) {
-                player.take_damage();
-                if (player.get_lives() <= 0) game_over = true;
+        for (size_t i = 0; i < n; i++) {
+            if (!contact[i] || !alive[i] || kinds[i] != KIND_PLAYER_BULLET) continue;
+            int bx = bullets.x[i], by = bullets.y[i];
+            const SweptBox shot = swept(bullets, i, 1, 1);
+            const CellRange path = cells_of(shot);
+            // Everything the shot's path crossed this tick, visited in index order.
+            candidates.clear();
+            for_cells(enemy_grid, path, collect);
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+            PROFILE_COUNT(profiler, COUNTER_COLLISION_TESTS, candidates.size());
+            for (int e : candidates) {
+                if (enemies.alive[e] && swept_overlap(shot, swept(enemies, e, 1, 1))) {
+                    enemies.kill(e);
+                    alive[i] = 0;
+                    emit(EVENT_ENEMY_KILLED, enemies.kind[e], bx, by, 1);
+                }
+            }
+            candidates.clear();
+            for_cells(boss_grid, path, collect);
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+            for (int b : candidates) {
+                if (bosses.alive[b] && swept_overlap(shot, swept(bosses, b, Boss::width, Boss::height))) {
+                    Boss::take_damage(bosses, b);
+                    alive[i] = 0;
+                    emit(EVENT_BOSS_HIT, KIND_BOSS, bx, by, 5);
+                    if (!bosses.alive[b]) emit(EVENT_BOSS_KILLED, KIND_BOSS, bx, by);
+                }
             }
         }
-        for (auto& bullet : bullets) {
-            if (bullet.is_active() && !bullet.is_from_player() &&
-                bullet.get_x() == player.get_x() && bullet.get_y() == player.get_y()) {
+    }
+
+    // A full ring is drained on the spot rather than dropping an event; the
+    // reactions below never feed back into detection, so the tick ends the same.
+    void Game::emit(GameEventType type, unsigned char kind, int x, int y, int points) {
+        if (events.full()) dispatch_events();
+        events.push(GameEvent{type, kind, int16_t(points), x, y});
+    }
+
+    // The systems reacting to the tick's events, each applied in the order
+    // the events happened: score, player damage, stats counters, HUD.
+    void Game::dispatch_events() {
+        events.drain([this](const GameEvent& e) {
+            score += e.points;
+            if (e.type == EVENT_PLAYER_HIT) {
                 player.take_damage();
-                bullet.deactivate();
                 if (player.get_lives() <= 0) game_over = true;
             }
+            stats.events[e.type]++;
+            post_message(e);
+        });
+    }
+
+    void Game::post_message(const GameEvent& e) {
+        char text[sizeof(messages[0].text)] = {};
+        switch (e.type) {
+        case EVENT_PLAYER_HIT:
+            snprintf(text, sizeof(text), "Hit by %s!", e.kind == KIND_BOSS ? "the boss"
+                : e.kind == KIND_ENEMY_BULLET ? "a shot" : "an enemy");
+            break;
+        case EVENT_ENEMY_KILLED:
+            snprintf(text, sizeof(text), "Hit Enemy at (%d, %d)!", e.x, e.y);
+            break;
+        case EVENT_BOSS_HIT:
+            snprintf(text, sizeof(text), "Hit Boss at (%d, %d)!", e.x, e.y);
+            break;
+        case EVENT_BOSS_KILLED:
+            snprintf(text, sizeof(text), "Boss destroyed!");
+            break;
+        case EVENT_BOSS_SPAWNED:
+            snprintf(text, sizeof(text), "Boss incoming!");
+            break;
+        default:
+            return;
         }
-        for (auto& bullet : bullets) {
-            if (bullet.is_active() && bullet.is_from_player()) {
-                for (auto& enemy : enemies) {
-                    if (enemy.is_active() &&
-                        abs(bullet.get_x() - enemy.get_x()) <= 1 &&
-                        bullet.get_y() == enemy.get_y()) {
-                        enemy.deactivate();
-                        bullet.deactivate();
-                        score += 1;
-                        mvprintw(1, 0, "Hit Enemy at (%d, %d)!", bullet.get_x(), bullet.get_y());
-                    }
-                }
-                for (auto& boss : bosses) {
-                    if (boss.is_active() && boss.collides(bullet.get_x(), bullet.get_y())) {
-                        boss.take_damage();
-                        bullet.deactivate();
-                        score += 5;
-                        mvprintw(2, 0, "Hit Boss at (%d, %d)!", bullet.get_x(), bullet.get_y());
-                    }
-                }
+        memmove(messages + 1, messages, sizeof(messages) - sizeof(messages[0]));
+        memcpy(messages[0].text, text, sizeof(text));
+        messages[0].until = ticks + MESSAGE_TICKS;
+    }
+
+    // Enemy shots are screened by the vectorized bounding-box pass first, so
+    // the exact swept test only runs on the few that come near the player.
+    void Game::probe_contacts(size_t begin, size_t end) {
+        const int px = player.get_x() * FIX_ONE, py = player.get_y() * FIX_ONE;
+        const SweptBox me{px, py, px, py, FIX_ONE, FIX_ONE};
+        Bullet::threats(bullets, player.get_x(), player.get_y(), begin, end, contact.data());
+        for (size_t i = begin; i < end; i++) {
+            if (!bullets.alive[i]) continue;
+            const SweptBox shot = swept(bullets, i, 1, 1);
+            bool hit = false;
+            if (bullets.kind[i] == KIND_ENEMY_BULLET) {
+                if (!contact[i]) continue;
+                hit = swept_overlap(shot, me);
+            } else {
+                const CellRange path = cells_of(shot);
+                for_cells(enemy_grid, path, [&](int e) {
+                    hit = hit || swept_overlap(shot, swept(enemies, e, 1, 1));
+                });
+                for_cells(boss_grid, path, [&](int b) {
+                    hit = hit || swept_overlap(shot, swept(bosses, b, Boss::width, Boss::height));
+                });
             }
+            contact[i] = hit;
         }
     }
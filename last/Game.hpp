@@ -1,30 +1,160 @@
 #pragma once
 #include <vector>
 #include <chrono>
+#include <string>
 #include "Player.hpp"
 #include "Bullet.hpp"
 #include "Enemy.hpp"
-class Boss;
+#include "EntityStore.hpp"
+#include "SpatialGrid.hpp"
+#include "FrameBuffer.hpp"
+#include "Renderer.hpp"
+#include "Constants.hpp"
+#include "Rng.hpp"
+#include "Recording.hpp"
+#include "InputQueue.hpp"
+#include "JobSystem.hpp"
+#include "World.hpp"
+#include "FlowField.hpp"
+#include "Snapshot.hpp"
+#include "RewindBuffer.hpp"
+#include "WaveSchedule.hpp"
+#include "EventBus.hpp"
+#include "Profiler.hpp"
+#include "AllocStats.hpp"
+
+struct LoopStats {
+    int sim_ticks = 0;                  // simulation ticks run in the last frame
+    long slack_us = 0;                  // time left over before the next wake-up
+    long overruns = 0;                  // frames whose work outlasted their budget
+    long dropped_ticks = 0;             // ticks discarded by the catch-up cap
+    long frames = 0;
+    long rendered = 0;
+    long allocations = 0;               // container growths since start; 0 in steady state
+    long cells_written = 0;             // cells emitted by the last render
+    long input_events = 0;
+    long input_latency_us = 0;          // key read to first frame presented after it
+    long input_latency_max_us = 0;
+    long input_latency_sum_us = 0;
+    long input_latency_samples = 0;
+    long rewind_bytes = 0;              // memory held by the rewind ring
+    long output_bytes = 0;              // sent to the terminal by the last present
+    long output_writes = 0;
+    long events[EVENT_COUNT] = {};      // gameplay events dispatched, by type
+};
+
+struct PhaseTimes {
+    long input_ns = 0;
+    long update_ns = 0;
+    long collide_ns = 0;
+    long render_ns = 0;
+    long snapshot_ns = 0;
+    long flow_ns = 0;                   // flow-field rebuild, part of update_ns
+};
+
+struct HudMessage {
+    char text[32];
+    int64_t until;                      // shown while ticks < until
+};
+
+struct GameConfig {
+    unsigned seed = 0;
+    long max_ticks = 0;                 // headless runs stop here; 0 runs until game over
+    int bullet_capacity = BULLET_CAPACITY;
+    int enemy_capacity = ENEMY_CAPACITY;
+    int boss_capacity = BOSS_CAPACITY;
+    bool time_phases = false;           // fill PhaseTimes on every tick
+    int threads = 1;                    // job-system threads, including the caller
+    int world_width = WIDTH;            // arena size; the terminal only sets the viewport
+    int world_height = HEIGHT;
+    int rewind_seconds = 0;             // length of the rewind ring; 0 disables it
+    std::string level_path;             // wave schedule; empty spawns at random
+};
 
 class Game {
 public:
+    Renderer& renderer;
+    GameConfig config;
     Player player;
-    std::vector<Bullet> bullets;
-    std::vector<Enemy> enemies;
-    std::vector<Boss> bosses;
+    int player_ox, player_oy;           // the player's cell before this tick's moves
+    EntityStore bullets;
+    EntityStore enemies;
+    EntityStore bosses;
     int score;
     bool game_over;
-    std::chrono::steady_clock::time_point start_time;
+    long ticks;
+    LoopStats stats;
+    PhaseTimes phases;
+    World world;
+    FlowField field;
+    int cam_x, cam_y;
+    SpatialGrid enemy_grid;
+    SpatialGrid boss_grid;
+    std::vector<int> candidates;
+    FrameBuffer screen;
+    HudMessage messages[MESSAGE_LINES]; // newest first
+    Rng spawn_rng;
+    Rng move_rng;
+    Rng fire_rng;
+    Rng boss_rng;
+    WaveSchedule waves;
+    std::vector<uint32_t> move_rolls;
+    std::vector<uint32_t> fire_rolls;
+    std::vector<unsigned char> shoot;
+    std::vector<unsigned char> contact;
+    EventBus events;
+    JobSystem jobs;
+    RewindBuffer history;
+    std::vector<uint8_t> state_buf;
+    std::vector<Rect> walls_buf;
+    EntityStore bullets_buf;            // load_state() decodes into these, then swaps
+    EntityStore enemies_buf;
+    EntityStore bosses_buf;
+    Recording* recorder;
+    Recording* replay;
+    InputQueue input;
+    int64_t undisplayed_stamp;
+    int last_key;
+    OutputStats output_seen;            // renderer totals as of the previous frame
+#ifdef SHMUP_PROFILE
+    Profiler profiler;
+#endif
 
 public:
-    Game();
+    Game(Renderer& renderer_, const GameConfig& config_);
     ~Game();
     void run();
+    void tick(int input);
+    void tick(const int* keys, int count);
+    void step(int input);
+    void fast_forward(long tick);
+    void reset(unsigned seed);
+    void record_to(Recording& log);
+    void replay_from(Recording& log);
+    uint64_t state_hash() const;
+    void save_state(std::vector<uint8_t>& out) const;
+    bool load_state(const uint8_t* data, size_t len);
+    bool rewind(long back);
+    bool profile_to(const char* path);
+    const LoopStats& loop_stats() const;
+    const PhaseTimes& phase_times() const;
 
 private:
+    void run_realtime();
+    void run_headless();
+    void queue_key(int key);
+    void resize_view();
+    void follow_player();
+    int take_input(int64_t until_ns, int* keys);
     void cleanup();
     void handle_input(int input);
-    void update(int input);
-    void render(int input);
+    void update(const int* keys, int count);
+    void spawn_wave(const WaveEntry& e);
+    void render();
+    void build_grids();
     void check_collisions();
+    void emit(GameEventType type, unsigned char kind, int x, int y, int points = 0);
+    void dispatch_events();
+    void post_message(const GameEvent& e);
+    void probe_contacts(size_t begin, size_t end);
 };
\ No newline at end of file
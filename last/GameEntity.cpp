@@ -2,14 +2,9 @@
 #include "Constants.hpp"
 #include <ncursesw/ncurses.h>
 
-    GameEntity::GameEntity(int x_, int y_, const cchar_t& s) : x(x_), y(y_), symbol(s), active(true) {}
-    void GameEntity::update([[maybe_unused]] int input) {}
-    void GameEntity::render() const {
-        if (active) {
-            mvadd_wch(y, x, &symbol);
-        }
+    GameEntity::GameEntity(int x_, int y_, SpriteId s) : x(x_), y(y_), sprite(s) {}
+    void GameEntity::render(FrameBuffer& fb, int cam_x, int cam_y) const {
+        fb.blit(x - cam_x, y - cam_y, sprite);
     }
-    bool GameEntity::is_active() const { return active; }
     int GameEntity::get_x() const { return x; }
-    int GameEntity::get_y() const { return y; }
-    void GameEntity::deactivate() { active = false; }
\ No newline at end of file
+    int GameEntity::get_y() const { return y; }
\ No newline at end of file
@@ -1,18 +1,15 @@
 #pragma once
-#include <ncursesw/ncurses.h>
+#include "FrameBuffer.hpp"
 
+// Plain position/glyph base with no virtual dispatch: the only subclass is
+// Player, and bullets, enemies and bosses are batch systems over EntityStore.
 class GameEntity {
 protected:
     int x, y;
-    cchar_t symbol;
-    bool active;
+    SpriteId sprite;
 public:
-    GameEntity(int x_, int y_, const cchar_t& s);
-    virtual ~GameEntity() = default;
-    virtual void update([[maybe_unused]] int input);
-    virtual void render() const;
-    bool is_active() const;
+    GameEntity(int x_, int y_, SpriteId s);
+    void render(FrameBuffer& fb, int cam_x, int cam_y) const;
     int get_x() const;
     int get_y() const;
-    void deactivate();
 };
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "InputQueue.hpp"
+
+    InputQueue::InputQueue() : head(0), tail(0), dropped(0) {}
+    bool InputQueue::push(const InputEvent& ev) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == capacity) {
+            dropped++;
+            return false;
+        }
+        ring[h % capacity] = ev;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    bool InputQueue::peek(InputEvent& ev) const {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        ev = ring[t % capacity];
+        return true;
+    }
+    bool InputQueue::pop(InputEvent& ev) {
+        if (!peek(ev)) return false;
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+    size_t InputQueue::size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    long InputQueue::dropped_events() const { return dropped; }
@@ -0,0 +1,26 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+struct InputEvent {
+    int key;
+    int64_t stamp_ns;                   // steady_clock time the key was read
+};
+
+// Lock-free single-producer/single-consumer ring of timestamped keys. The
+// producer only writes head, the consumer only writes tail.
+class InputQueue {
+    static const size_t capacity = 256;
+    InputEvent ring[capacity];
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+    long dropped;
+public:
+    InputQueue();
+    bool push(const InputEvent& ev);
+    bool peek(InputEvent& ev) const;
+    bool pop(InputEvent& ev);
+    size_t size() const;
+    long dropped_events() const;
+};
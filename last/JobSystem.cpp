@@ -0,0 +1,86 @@
+#include "JobSystem.hpp"
+
+    JobSystem::JobSystem(int thread_count) : deques(thread_count > 1 ? thread_count : 1), remaining(0),
+        stolen(0), generation(0), stopping(false), kernel(nullptr), context(nullptr) {
+        for (Deque& d : deques) d.ring.resize(max_chunks_per_worker);
+        for (size_t i = 1; i < deques.size(); i++) threads.emplace_back(&JobSystem::worker, this, i);
+    }
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> guard(wake_lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : threads) t.join();
+    }
+    int JobSystem::thread_count() const { return deques.size(); }
+    long JobSystem::steals() const { return stolen.load(std::memory_order_relaxed); }
+    bool JobSystem::pop(size_t self, Chunk& c) {
+        {
+            Deque& own = deques[self];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (own.head != own.tail) {
+                c = own.ring[--own.tail];
+                return true;
+            }
+        }
+        for (size_t i = 1; i < deques.size(); i++) {
+            Deque& victim = deques[(self + i) % deques.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.head != victim.tail) {
+                c = victim.ring[victim.head++];
+                stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+    void JobSystem::drain(size_t self) {
+        Chunk c;
+        while (pop(self, c)) {
+            kernel(context, c.begin, c.end);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+    void JobSystem::worker(size_t self) {
+        unsigned seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard(wake_lock);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            drain(self);
+        }
+    }
+    void JobSystem::dispatch(size_t count, size_t grain, Kernel k, void* ctx) {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+        size_t limit = max_chunks_per_worker * deques.size();
+        if ((count + grain - 1) / grain > limit) grain = (count + limit - 1) / limit;
+        if (deques.size() == 1 || count <= grain) {
+            k(ctx, 0, count);
+            return;
+        }
+        kernel = k;
+        context = ctx;
+        size_t chunks = (count + grain - 1) / grain;
+        remaining.store(chunks, std::memory_order_release);
+        for (size_t w = 0; w < deques.size(); w++) {
+            Deque& d = deques[w];
+            std::lock_guard<std::mutex> guard(d.lock);
+            d.head = d.tail = 0;
+            for (size_t c = w; c < chunks; c += deques.size()) {
+                size_t b = c * grain;
+                d.ring[d.tail++] = Chunk{b, b + grain < count ? b + grain : count};
+            }
+        }
+        {
+            std::lock_guard<std::mutex> guard(wake_lock);
+            generation++;
+        }
+        wake.notify_all();
+        drain(0);
+        while (remaining.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+    }
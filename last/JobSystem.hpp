@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join pool for data-parallel sweeps. parallel_for splits a range into
+// chunks dealt round-robin onto per-worker deques; each worker pops from the
+// back of its own deque and steals from the front of the others. The calling
+// thread works too, and the call returns once every chunk is done. Nothing is
+// allocated per call.
+class JobSystem {
+    struct Chunk {
+        size_t begin, end;
+    };
+    struct Deque {
+        std::mutex lock;
+        std::vector<Chunk> ring;
+        size_t head = 0, tail = 0;
+    };
+    typedef void (*Kernel)(void* ctx, size_t begin, size_t end);
+
+    std::vector<std::thread> threads;
+    std::vector<Deque> deques;
+    std::mutex wake_lock;
+    std::condition_variable wake;
+    std::atomic<size_t> remaining;
+    std::atomic<long> stolen;
+    unsigned generation;
+    bool stopping;
+    Kernel kernel;
+    void* context;
+
+    bool pop(size_t self, Chunk& c);
+    void drain(size_t self);
+    void worker(size_t self);
+    void dispatch(size_t count, size_t grain, Kernel k, void* ctx);
+
+public:
+    static const size_t max_chunks_per_worker = 256;
+
+    explicit JobSystem(int thread_count);
+    ~JobSystem();
+    int thread_count() const;
+    long steals() const;
+
+    template <typename F>
+    void parallel_for(size_t count, size_t grain, F& fn) {
+        dispatch(count, grain, [](void* ctx, size_t b, size_t e) { (*static_cast<F*>(ctx))(b, e); }, &fn);
+    }
+};
@@ -0,0 +1,91 @@
+#include "NcursesRenderer.hpp"
+#include "Constants.hpp"
+#include "Atlas.hpp"
+#include <ncursesw/ncurses.h>
+#include <clocale>
+#include <thread>
+#include <chrono>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+    NcursesRenderer::NcursesRenderer() {
+        setlocale(LC_ALL, "");
+        io_fd = open("/proc/self/io", O_RDONLY);
+        baseline = process_writes();
+        initscr();
+        cbreak();
+        noecho();
+        keypad(stdscr, TRUE);
+        nodelay(stdscr, TRUE);
+        curs_set(0);
+        struct Style { short fg; attr_t attr; };
+        static const Style styles[PAL_COUNT] = {
+            {-1, A_NORMAL}, {-1, A_DIM}, {COLOR_CYAN, A_BOLD}, {COLOR_YELLOW, A_NORMAL},
+            {COLOR_RED, A_NORMAL}, {COLOR_GREEN, A_NORMAL}, {COLOR_MAGENTA, A_NORMAL}, {COLOR_RED, A_BOLD},
+            {COLOR_BLUE, A_BOLD}};
+        bool color = has_colors() && start_color() == OK && use_default_colors() == OK;
+        for (short p = 1; color && p < PAL_COUNT; p++) init_pair(p, styles[p].fg, -1);
+        const Atlas& atlas = Atlas::shared();
+        glyphs.resize(atlas.size());
+        for (size_t i = 0; i < atlas.size(); i++) {
+            const Glyph& g = atlas.glyph(i);
+            wchar_t w[2] = {g.ch, L'\0'};
+            setcchar(&glyphs[i], w, styles[g.color].attr, color ? g.color : 0, nullptr);
+        }
+    }
+    NcursesRenderer::~NcursesRenderer() {
+        endwin();
+        if (io_fd >= 0) close(io_fd);
+    }
+    int NcursesRenderer::read_key() { return getch(); }
+    int NcursesRenderer::wait_key(int timeout_ms) {
+        timeout(timeout_ms);
+        int key = getch();
+        nodelay(stdscr, TRUE);
+        return key;
+    }
+    void NcursesRenderer::present(FrameBuffer& fb) {
+        long written = 0;
+        for (int y = 0; y < fb.get_height(); y++)
+            for (int x = 0; x < fb.get_width(); x++) {
+                if (!fb.dirty(x, y)) continue;
+                GlyphId g = fb.at(x, y);
+                if (g == Atlas::WIDE_TAIL) continue;
+                mvadd_wch(y, x, &glyphs[g]);
+                written++;
+            }
+        fb.flip(written);
+        refresh();
+    }
+    void NcursesRenderer::viewport(int& w, int& h) const { getmaxyx(stdscr, h, w); }
+    void NcursesRenderer::game_over(int score) {
+        int w, h;
+        viewport(w, h);
+        clear();
+        mvprintw(h / 2, w / 2 - 5, "Game Over! Score: %d", score);
+        refresh();
+        std::this_thread::sleep_for(std::chrono::seconds(3));
+    }
+    bool NcursesRenderer::realtime() const { return true; }
+    // ncurses writes to the terminal's descriptor itself, so its traffic is
+    // taken from the kernel's per-process write counters. Nothing else
+    // writes while a game is on screen.
+    OutputStats NcursesRenderer::process_writes() const {
+        OutputStats s;
+        char buf[512];
+        ssize_t n = io_fd >= 0 ? pread(io_fd, buf, sizeof(buf) - 1, 0) : -1;
+        if (n <= 0) return s;
+        buf[n] = '\0';
+        if (const char* p = strstr(buf, "wchar:")) s.bytes = strtol(p + 6, nullptr, 10);
+        if (const char* p = strstr(buf, "syscw:")) s.writes = strtol(p + 6, nullptr, 10);
+        return s;
+    }
+    OutputStats NcursesRenderer::output() const {
+        OutputStats now = process_writes();
+        now.bytes -= baseline.bytes;
+        now.writes -= baseline.writes;
+        return now;
+    }
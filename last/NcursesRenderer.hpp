@@ -0,0 +1,22 @@
+#pragma once
+#include <ncursesw/ncurses.h>
+#include <vector>
+#include "Renderer.hpp"
+
+class NcursesRenderer : public Renderer {
+    std::vector<cchar_t> glyphs;        // one per atlas glyph, built at startup
+    int io_fd;                          // /proc/self/io, read for output()
+    OutputStats baseline;
+
+    OutputStats process_writes() const;
+public:
+    NcursesRenderer();
+    ~NcursesRenderer() override;
+    int read_key() override;
+    int wait_key(int timeout_ms) override;
+    void present(FrameBuffer& fb) override;
+    void viewport(int& w, int& h) const override;
+    void game_over(int score) override;
+    bool realtime() const override;
+    OutputStats output() const override;
+};
@@ -0,0 +1,25 @@
+#include "NullRenderer.hpp"
+#include "Constants.hpp"
+
+    NullRenderer::NullRenderer(const std::vector<int>& script_) : script(script_), cursor(0) {}
+    int NullRenderer::read_key() {
+        if (script.empty()) return KEY_NONE;
+        int key = script[cursor];
+        cursor = (cursor + 1) % script.size();
+        return key;
+    }
+    int NullRenderer::wait_key([[maybe_unused]] int timeout_ms) { return read_key(); }
+    void NullRenderer::present(FrameBuffer& fb) {
+        long written = 0;
+        for (int y = 0; y < fb.get_height(); y++)
+            for (int x = 0; x < fb.get_width(); x++)
+                if (fb.dirty(x, y) && fb.at(x, y) != Atlas::WIDE_TAIL) written++;
+        fb.flip(written);
+    }
+    void NullRenderer::viewport(int& w, int& h) const {
+        w = WIDTH;
+        h = HEIGHT;
+    }
+    void NullRenderer::game_over([[maybe_unused]] int score) {}
+    bool NullRenderer::realtime() const { return false; }
+    OutputStats NullRenderer::output() const { return OutputStats(); }
@@ -0,0 +1,20 @@
+#pragma once
+#include "Renderer.hpp"
+#include <vector>
+#include <cstddef>
+
+// Headless backend: no terminal, no sleeping. Keys come from a script that
+// is replayed one entry per tick and repeats once exhausted.
+class NullRenderer : public Renderer {
+    std::vector<int> script;
+    size_t cursor;
+public:
+    explicit NullRenderer(const std::vector<int>& script_ = std::vector<int>());
+    int read_key() override;
+    int wait_key(int timeout_ms) override;
+    void present(FrameBuffer& fb) override;
+    void viewport(int& w, int& h) const override;
+    void game_over(int score) override;
+    bool realtime() const override;
+    OutputStats output() const override;
+};
@@ -2,16 +2,18 @@
 #include "Game.hpp"
 #include "Constants.hpp"
 
-    Player::Player(int x_, int y_) : GameEntity(x_, y_, [] {
-        cchar_t s;
-        setcchar(&s, L"🦚", 0, 0, nullptr);
-        return s;
-    }()), lives(PLAYER_LIVES) {}
+    Player::Player(int x_, int y_, int world_w, int world_h) : GameEntity(x_, y_, SPRITE_PLAYER), lives(PLAYER_LIVES),
+        max_x(world_w / 4), max_y(world_h - 1) {}
     void Player::update(int input) {
         if ((input == KEY_UP || input == 'w') && y > 1) y--;
-        if ((input == KEY_DOWN || input == 's') && y < HEIGHT - 1) y++;
+        if ((input == KEY_DOWN || input == 's') && y < max_y) y++;
         if ((input == KEY_LEFT || input == 'a') && x > 0) x--;
-        if ((input == KEY_RIGHT || input == 'd') && x < WIDTH / 4) x++;
+        if ((input == KEY_RIGHT || input == 'd') && x < max_x) x++;
     }
     int Player::get_lives() const { return lives; }
-    void Player::take_damage() { lives--; }
\ No newline at end of file
+    void Player::take_damage() { lives--; }
+    void Player::restore(int x_, int y_, int lives_) {
+        x = x_;
+        y = y_;
+        lives = lives_;
+    }
\ No newline at end of file
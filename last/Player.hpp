@@ -9,12 +9,15 @@
 #include <string>
 #include <algorithm>
 #include "GameEntity.hpp"
+#include "Constants.hpp"
 
 class Player : public GameEntity {
     int lives;
+    int max_x, max_y;
 public:
-    Player(int x_, int y_);
-    void update(int input) override;
+    Player(int x_, int y_, int world_w = WIDTH, int world_h = HEIGHT);
+    void update(int input);
     int get_lives() const;
     void take_damage();
+    void restore(int x_, int y_, int lives_);
 };
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "Profiler.hpp"
+#ifdef SHMUP_PROFILE
+#include "FrameBuffer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+static const char* const zone_names[ZONE_COUNT] = {"input", "update", "collide", "render", "refresh", "sleep"};
+static const char* const counter_names[COUNTER_COUNT] = {"bullets", "enemies", "bosses", "collision_tests", "cells"};
+static const wchar_t bar_chars[] = L" ▁▂▃▄▅▆▇█";
+
+    Profiler::Profiler() : event_count(0), dropped_events(0), origin_ns(now()), frame_start_ns(origin_ns),
+        frame(0), out(nullptr), csv(false), records(0), overlay(false) {
+        memset(zone_ns, 0, sizeof(zone_ns));
+        memset(frame_ns, 0, sizeof(frame_ns));
+        memset(counters, 0, sizeof(counters));
+        for (int i = 0; i < 9; i++) bars[i] = Atlas::shared().find(bar_chars[i]);
+    }
+    Profiler::~Profiler() {
+        if (!out) return;
+        if (!csv) fprintf(out, "\n]\n");
+        fclose(out);
+    }
+    int64_t Profiler::now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    bool Profiler::open(const char* path) {
+        size_t len = strlen(path);
+        out = fopen(path, "w");
+        if (!out) return false;
+        csv = len >= 4 && !strcmp(path + len - 4, ".csv");
+        if (csv) {
+            fprintf(out, "frame,start_us,frame_us");
+            for (const char* name : zone_names) fprintf(out, ",%s_us", name);
+            for (const char* name : counter_names) fprintf(out, ",%s", name);
+            fprintf(out, "\n");
+        } else {
+            fprintf(out, "[");
+        }
+        return true;
+    }
+    void Profiler::end_frame() {
+        int64_t t = now();
+        int slot = frame % history;
+        frame_ns[slot] = t - frame_start_ns;
+        for (int z = 0; z < ZONE_COUNT; z++) zone_ns[slot][z] = 0;
+        for (int i = 0; i < event_count; i++) zone_ns[slot][events[i].zone] += events[i].dur_ns;
+        if (out) write_frame(slot);
+        event_count = 0;
+        counters[COUNTER_COLLISION_TESTS] = 0;
+        frame_start_ns = t;
+        frame++;
+    }
+    void Profiler::write_frame(int slot) {
+        if (csv) {
+            fprintf(out, "%ld,%.3f,%.3f", frame, (frame_start_ns - origin_ns) / 1e3, frame_ns[slot] / 1e3);
+            for (int z = 0; z < ZONE_COUNT; z++) fprintf(out, ",%.3f", zone_ns[slot][z] / 1e3);
+            for (long c : counters) fprintf(out, ",%ld", c);
+            fprintf(out, "\n");
+            return;
+        }
+        for (int i = 0; i < event_count; i++)
+            fprintf(out, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                records++ ? "," : "", zone_names[events[i].zone],
+                (events[i].start_ns - origin_ns) / 1e3, events[i].dur_ns / 1e3);
+        fprintf(out, "%s\n{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{",
+            records++ ? "," : "", (frame_start_ns - origin_ns) / 1e3);
+        for (int c = 0; c < COUNTER_COUNT; c++)
+            fprintf(out, "%s\"%s\":%ld", c ? "," : "", counter_names[c], counters[c]);
+        fprintf(out, "}}");
+    }
+    void Profiler::toggle_overlay() { overlay = !overlay; }
+    // One row per zone plus the whole frame: latest time and a sparkline of
+    // the last `history` frames, scaled to the row's own maximum.
+    void Profiler::draw(FrameBuffer& fb, int x, int y) const {
+        if (!overlay) return;
+        for (int row = 0; row <= ZONE_COUNT; row++) {
+            int64_t peak = 1;
+            for (int i = 0; i < history; i++)
+                peak = std::max(peak, row < ZONE_COUNT ? zone_ns[i][row] : frame_ns[i]);
+            int64_t last = row < ZONE_COUNT ? zone_ns[(frame + history - 1) % history][row]
+                : frame_ns[(frame + history - 1) % history];
+            fb.text(x, y + row, "%.3s %6ldus", row < ZONE_COUNT ? zone_names[row] : "frm", long(last / 1000));
+            for (int i = 0; i < history; i++) {
+                int slot = (frame + i) % history;
+                int64_t v = row < ZONE_COUNT ? zone_ns[slot][row] : frame_ns[slot];
+                fb.put(x + 12 + i, y + row, bars[v ? 1 + v * 7 / peak : 0]);
+            }
+        }
+    }
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+// Frame profiler, built only with -DSHMUP_PROFILE (make profile). Otherwise
+// every PROFILE_* macro expands to nothing and no profiler state exists.
+#ifdef SHMUP_PROFILE
+#include <cstdint>
+#include <cstdio>
+#include "Atlas.hpp"
+
+class FrameBuffer;
+
+enum ProfileZone : unsigned char {
+    ZONE_INPUT,
+    ZONE_UPDATE,
+    ZONE_COLLIDE,
+    ZONE_RENDER,
+    ZONE_REFRESH,
+    ZONE_SLEEP,
+    ZONE_COUNT
+};
+
+enum ProfileCounter : unsigned char {
+    COUNTER_BULLETS,
+    COUNTER_ENEMIES,
+    COUNTER_BOSSES,
+    COUNTER_COLLISION_TESTS,
+    COUNTER_CELLS,
+    COUNTER_COUNT
+};
+
+// Collects timed zones for the current frame into a fixed array, folds them
+// into a rolling per-zone history at end_frame(), and optionally streams
+// every frame to a Chrome trace-event JSON (*.json) or CSV file.
+class Profiler {
+    struct Event {
+        ProfileZone zone;
+        int64_t start_ns;
+        int64_t dur_ns;
+    };
+    static const int max_events = 64;
+    static const int history = 16;
+    Event events[max_events];
+    int event_count;
+    long dropped_events;
+    int64_t origin_ns;
+    int64_t frame_start_ns;
+    int64_t zone_ns[history][ZONE_COUNT];
+    int64_t frame_ns[history];
+    long counters[COUNTER_COUNT];
+    long frame;
+    FILE* out;
+    bool csv;
+    long records;                       // objects written to the trace so far
+    bool overlay;
+    GlyphId bars[9];                    // sparkline levels, empty to full
+
+    void write_frame(int slot);
+public:
+    Profiler();
+    ~Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    static int64_t now();
+    bool open(const char* path);
+    void record(ProfileZone zone, int64_t start_ns, int64_t end_ns) {
+        if (event_count < max_events) events[event_count++] = Event{zone, start_ns, end_ns - start_ns};
+        else dropped_events++;
+    }
+    void count(ProfileCounter c, long n) { counters[c] += n; }
+    void set(ProfileCounter c, long n) { counters[c] = n; }
+    void end_frame();
+    void toggle_overlay();
+    void draw(FrameBuffer& fb, int x, int y) const;
+};
+
+class ProfileScope {
+    Profiler& profiler;
+    ProfileZone zone;
+    int64_t start;
+public:
+    ProfileScope(Profiler& profiler_, ProfileZone zone_) : profiler(profiler_), zone(zone_), start(Profiler::now()) {}
+    ~ProfileScope() { profiler.record(zone, start, Profiler::now()); }
+};
+
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(prof, zone) ProfileScope PROFILE_JOIN(profile_scope_, __LINE__)(prof, zone)
+#define PROFILE_COUNT(prof, counter, n) (prof).count(counter, n)
+#define PROFILE_SET(prof, counter, n) (prof).set(counter, n)
+#define PROFILE_FRAME(prof) (prof).end_frame()
+#else
+#define PROFILE_SCOPE(prof, zone) ((void)0)
+#define PROFILE_COUNT(prof, counter, n) ((void)0)
+#define PROFILE_SET(prof, counter, n) ((void)0)
+#define PROFILE_FRAME(prof) ((void)0)
+#endif
@@ -0,0 +1,134 @@
+#include "Recording.hpp"
+#include "Game.hpp"
+#include "Constants.hpp"
+#include <cstdio>
+#include <cstring>
+
+static const uint16_t RECORDING_VERSION = 10;
+
+static void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(uint8_t(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(uint8_t(v));
+}
+
+static bool get_varint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; pos < in.size() && shift < 64; shift += 7) {
+        uint8_t b = in[pos++];
+        v |= uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+static int64_t unzigzag(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+    Recording::Recording() : open_start(0), open_run(0), last_end(0), open_key(KEY_NONE),
+        cursor(0), read_end(0), read_next(0), read_key(KEY_NONE), read_live(false) {
+        memset(&header, 0, sizeof(header));
+    }
+    void Recording::begin(const GameConfig& config) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "SHMR", 4);
+        header.version = RECORDING_VERSION;
+        header.seed = config.seed;
+        header.bullet_capacity = config.bullet_capacity;
+        header.enemy_capacity = config.enemy_capacity;
+        header.boss_capacity = config.boss_capacity;
+        header.world_width = config.world_width;
+        header.world_height = config.world_height;
+        config.level_path.copy(header.level, sizeof(header.level) - 1);
+        stream.clear();
+        stream.reserve(4096);
+        open_run = 0;
+        last_end = 0;
+    }
+    void Recording::flush() {
+        if (open_run == 0) return;
+        put_varint(stream, open_start - last_end);
+        put_varint(stream, zigzag(open_key));
+        put_varint(stream, open_run - 1);
+        last_end = open_start + open_run - 1;
+        open_run = 0;
+    }
+    void Recording::record(int64_t tick, int key) {
+        if (key == KEY_NONE) return;
+        if (open_run && key == open_key && open_start + open_run == tick) {
+            open_run++;
+            return;
+        }
+        flush();
+        open_start = tick;
+        open_key = key;
+        open_run = 1;
+    }
+    void Recording::finish(int64_t ticks, uint64_t hash) {
+        flush();
+        header.ticks = ticks;
+        header.final_hash = hash;
+    }
+    bool Recording::save(const char* path) const {
+        FILE* f = fopen(path, "wb");
+        if (!f) return false;
+        bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(stream.data(), 1, stream.size(), f) == stream.size();
+        return fclose(f) == 0 && ok;
+    }
+    bool Recording::load(const char* path) {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+        bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+            !memcmp(header.magic, "SHMR", 4) && header.version == RECORDING_VERSION;
+        stream.clear();
+        uint8_t buf[4096];
+        size_t n;
+        while (ok && (n = fread(buf, 1, sizeof(buf), f)) > 0) stream.insert(stream.end(), buf, buf + n);
+        fclose(f);
+        rewind();
+        return ok;
+    }
+    void Recording::apply(GameConfig& config) const {
+        config.seed = header.seed;
+        config.bullet_capacity = header.bullet_capacity;
+        config.enemy_capacity = header.enemy_capacity;
+        config.boss_capacity = header.boss_capacity;
+        config.world_width = header.world_width;
+        config.world_height = header.world_height;
+        config.level_path.assign(header.level, strnlen(header.level, sizeof(header.level)));
+    }
+    void Recording::rewind() {
+        cursor = 0;
+        read_end = 0;
+        read_next = 0;
+        read_live = false;
+    }
+    bool Recording::decode() {
+        uint64_t gap, key, run;
+        if (!get_varint(stream, cursor, gap) || !get_varint(stream, cursor, key) || !get_varint(stream, cursor, run))
+            return false;
+        read_next = read_end + gap;
+        read_end = read_next + run;
+        read_key = unzigzag(key);
+        read_live = true;
+        return true;
+    }
+    int Recording::next_key(int64_t tick) {
+        while (true) {
+            if (!read_live && !decode()) return KEY_NONE;
+            if (read_next > tick) return KEY_NONE;
+            if (read_end < tick) {
+                read_live = false;
+                continue;
+            }
+            read_next = tick + 1;
+            if (read_next > read_end) read_live = false;
+            return read_key;
+        }
+    }
+    int64_t Recording::ticks() const { return header.ticks; }
+    uint64_t Recording::final_hash() const { return header.final_hash; }
+    size_t Recording::stream_bytes() const { return stream.size(); }
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct GameConfig;
+
+struct RecordingHeader {
+    char magic[4];
+    uint16_t version;
+    uint32_t seed;
+    int32_t bullet_capacity;
+    int32_t enemy_capacity;
+    int32_t boss_capacity;
+    int32_t world_width;
+    int32_t world_height;
+    int64_t ticks;
+    uint64_t final_hash;
+    char level[120];
+};
+
+// Compact input log: header plus a stream of (tick gap, key, run length)
+// varint triples. A key held over consecutive ticks is one entry, and idle
+// ticks cost nothing beyond the gap of the next entry.
+class Recording {
+    RecordingHeader header;
+    std::vector<uint8_t> stream;
+    // writer state
+    int64_t open_start, open_run, last_end;
+    int open_key;
+    // reader state
+    size_t cursor;
+    int64_t read_end, read_next;
+    int read_key;
+    bool read_live;
+
+    void flush();
+    bool decode();
+public:
+    Recording();
+    void begin(const GameConfig& config);
+    void record(int64_t tick, int key);
+    void finish(int64_t ticks, uint64_t hash);
+    bool save(const char* path) const;
+    bool load(const char* path);
+    void apply(GameConfig& config) const;
+    void rewind();
+    int next_key(int64_t tick);
+    int64_t ticks() const;
+    uint64_t final_hash() const;
+    size_t stream_bytes() const;
+};
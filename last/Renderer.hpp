@@ -0,0 +1,21 @@
+#pragma once
+#include "FrameBuffer.hpp"
+
+struct OutputStats {
+    long bytes = 0;                     // sent to the terminal since start
+    long writes = 0;                    // write() system calls that sent them
+};
+
+// Output and input backend for Game. The simulation never talks to the
+// terminal directly; it draws into a FrameBuffer and asks for keys here.
+class Renderer {
+public:
+    virtual ~Renderer() = default;
+    virtual int read_key() = 0;
+    virtual int wait_key(int timeout_ms) = 0;
+    virtual void present(FrameBuffer& fb) = 0;
+    virtual void viewport(int& w, int& h) const = 0;
+    virtual void game_over(int score) = 0;
+    virtual bool realtime() const = 0;
+    virtual OutputStats output() const = 0;
+};
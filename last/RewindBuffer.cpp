@@ -0,0 +1,123 @@
+#include "RewindBuffer.hpp"
+#include <cstring>
+#include <algorithm>
+
+static void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(uint8_t(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(uint8_t(v));
+}
+
+static uint64_t get_varint(const uint8_t*& p) {
+    uint64_t v = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = *p++;
+        v |= uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+}
+
+static uint32_t word(const uint8_t* p, size_t i) {
+    uint32_t w;
+    memcpy(&w, p + i * 4, 4);
+    return w;
+}
+
+    RewindBuffer::RewindBuffer(int seconds, int ticks_per_second) :
+        groups(seconds > 0 ? seconds + 1 : 0), head(0), count(0), frames_per_group(ticks_per_second),
+        deltas_high(0) {
+        for (Group& g : groups) g.frames.reserve(frames_per_group);
+    }
+    bool RewindBuffer::enabled() const { return !groups.empty(); }
+    void RewindBuffer::push(int64_t tick, const std::vector<uint8_t>& state) {
+        if (!enabled()) return;
+        Group* g = count ? &groups[head] : nullptr;
+        if (!g || g->frames.size() >= frames_per_group || g->keyframe.size() != state.size()) {
+            if (count) {
+                deltas_high = std::max(deltas_high, groups[head].deltas.capacity());
+                head = (head + 1) % groups.size();
+            }
+            if (count < groups.size()) count++;
+            g = &groups[head];
+            g->keyframe.assign(state.begin(), state.end());
+            g->deltas.clear();
+            g->deltas.reserve(std::max(deltas_high, state.size()));
+            g->frames.clear();
+            g->frames.push_back(Frame{tick, 0, 0});
+            return;
+        }
+        const uint8_t* key = g->keyframe.data();
+        const uint8_t* cur = state.data();
+        const size_t words = state.size() / 4;
+        const size_t offset = g->deltas.size();
+        size_t i = 0;
+        while (i < words) {
+            size_t same = i;
+            while (same + 16 <= words && !memcmp(key + same * 4, cur + same * 4, 64)) same += 16;
+            while (same < words && word(key, same) == word(cur, same)) same++;
+            if (same == words) break;
+            size_t diff = same;
+            while (diff < words && word(key, diff) != word(cur, diff)) diff++;
+            put_varint(g->deltas, same - i);
+            put_varint(g->deltas, diff - same);
+            g->deltas.insert(g->deltas.end(), cur + same * 4, cur + diff * 4);
+            i = diff;
+        }
+        g->frames.push_back(Frame{tick, offset, g->deltas.size() - offset});
+    }
+    RewindBuffer::Group* RewindBuffer::find(int64_t tick, size_t& frame) {
+        for (size_t n = 0; n < count; n++) {
+            Group& g = groups[(head + groups.size() - n) % groups.size()];
+            if (g.frames.empty() || g.frames.front().tick > tick) continue;
+            for (frame = g.frames.size(); frame-- > 0;)
+                if (g.frames[frame].tick == tick) return &g;
+            return nullptr;
+        }
+        return nullptr;
+    }
+    // Rebuilds the state of one tick from its keyframe; the result stays
+    // valid until the next call.
+    const std::vector<uint8_t>* RewindBuffer::seek(int64_t tick) {
+        size_t frame;
+        Group* g = find(tick, frame);
+        if (!g) return nullptr;
+        scratch.assign(g->keyframe.begin(), g->keyframe.end());
+        const Frame& f = g->frames[frame];
+        const uint8_t* p = g->deltas.data() + f.offset;
+        const uint8_t* end = p + f.length;
+        size_t at = 0;
+        while (p < end) {
+            at += get_varint(p) * 4;
+            size_t n = get_varint(p) * 4;
+            memcpy(scratch.data() + at, p, n);
+            p += n;
+            at += n;
+        }
+        return &scratch;
+    }
+    // Drops every frame newer than tick, so recording resumes from there.
+    void RewindBuffer::truncate_after(int64_t tick) {
+        while (count && groups[head].frames.front().tick > tick) {
+            groups[head].frames.clear();
+            count--;
+            if (count) head = (head + groups.size() - 1) % groups.size();
+        }
+        if (!count) return;
+        Group& g = groups[head];
+        while (g.frames.back().tick > tick) {
+            g.deltas.resize(g.frames.back().offset);
+            g.frames.pop_back();
+        }
+    }
+    int64_t RewindBuffer::oldest_tick() const {
+        if (!count) return -1;
+        return groups[(head + groups.size() - (count - 1)) % groups.size()].frames.front().tick;
+    }
+    size_t RewindBuffer::memory_bytes() const {
+        size_t total = scratch.capacity();
+        for (const Group& g : groups)
+            total += g.keyframe.capacity() + g.deltas.capacity() + g.frames.capacity() * sizeof(Frame);
+        return total;
+    }
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Ring of recent per-tick snapshots. Each group starts with a full keyframe
+// and stores the following ticks as word-level deltas against it: runs of
+// (unchanged words, changed words) followed by the changed words. Groups
+// are reused in place and each new one reserves as much delta space as the
+// busiest group before it, so once the ring has wrapped pushing costs no heap
+// work unless play gets busier than it has been.
+class RewindBuffer {
+    struct Frame {
+        int64_t tick;
+        size_t offset;                  // into Group::deltas
+        size_t length;
+    };
+    struct Group {
+        std::vector<uint8_t> keyframe;
+        std::vector<uint8_t> deltas;
+        std::vector<Frame> frames;
+    };
+    std::vector<Group> groups;
+    size_t head;                        // group receiving new frames
+    size_t count;
+    size_t frames_per_group;
+    size_t deltas_high;                 // largest delta stream a group has needed
+    std::vector<uint8_t> scratch;
+
+    Group* find(int64_t tick, size_t& frame);
+public:
+    RewindBuffer(int seconds, int ticks_per_second);
+    bool enabled() const;
+    void push(int64_t tick, const std::vector<uint8_t>& state);
+    const std::vector<uint8_t>* seek(int64_t tick);
+    void truncate_after(int64_t tick);
+    int64_t oldest_tick() const;
+    size_t memory_bytes() const;
+};
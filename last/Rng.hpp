@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// Independent random streams, one per subsystem, so a run is reproducible
+// from its seed and no system shares hidden state with another.
+enum RngStream : uint64_t {
+    RNG_SPAWN = 1,
+    RNG_ENEMY_MOVE,
+    RNG_ENEMY_FIRE,
+    RNG_BOSS
+};
+
+// PCG32 (XSH-RR): 64-bit state, selectable stream, 32-bit output.
+class Rng {
+    uint64_t state;
+    uint64_t inc;
+public:
+    Rng(uint64_t seed_ = 0, uint64_t stream = 0) { seed(seed_, stream); }
+    void seed(uint64_t seed_, uint64_t stream) {
+        state = 0;
+        inc = (stream << 1) | 1;
+        next();
+        state += seed_;
+        next();
+    }
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = ((old >> 18) ^ old) >> 27;
+        uint32_t rot = old >> 59;
+        return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+    }
+    // Uniform in [0, bound) by multiply-shift; replaces rand() % bound.
+    uint32_t below(uint32_t bound) { return (uint64_t(next()) * bound) >> 32; }
+    bool chance(uint32_t percent) { return below(100) < percent; }
+    void fill_below(uint32_t* out, size_t count, uint32_t bound) {
+        for (size_t i = 0; i < count; i++) out[i] = (uint64_t(next()) * bound) >> 32;
+    }
+    uint64_t raw_state() const { return state; }
+    uint64_t raw_stream() const { return inc; }
+    void restore(uint64_t state_, uint64_t inc_) {
+        state = state_;
+        inc = inc_;
+    }
+};
@@ -0,0 +1,60 @@
+#include "Snapshot.hpp"
+#include "Game.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+    Snapshot::Snapshot() : mapped(nullptr), mapped_len(0) {}
+    Snapshot::~Snapshot() { unmap(); }
+    bool Snapshot::save(const char* path, const std::vector<uint8_t>& state) {
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        bool ok = ftruncate(fd, state.size()) == 0;
+        void* p = ok ? mmap(nullptr, state.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        if (p != MAP_FAILED) {
+            memcpy(p, state.data(), state.size());
+            ok = munmap(p, state.size()) == 0;
+        } else {
+            ok = false;
+        }
+        return close(fd) == 0 && ok;
+    }
+    bool Snapshot::map(const char* path) {
+        unmap();
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+            p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        mapped = static_cast<const uint8_t*>(p);
+        mapped_len = st.st_size;
+        return true;
+    }
+    void Snapshot::unmap() {
+        if (mapped) munmap(const_cast<uint8_t*>(mapped), mapped_len);
+        mapped = nullptr;
+        mapped_len = 0;
+    }
+    const uint8_t* Snapshot::data() const { return mapped; }
+    size_t Snapshot::size() const { return mapped_len; }
+    bool Snapshot::header(const uint8_t* data, size_t len, SnapshotHeader& out) {
+        if (len < sizeof(out)) return false;
+        memcpy(&out, data, sizeof(out));
+        return !memcmp(out.magic, "SHMS", 4) && out.version == VERSION && out.bytes == len;
+    }
+    bool Snapshot::apply(const uint8_t* data, size_t len, GameConfig& config) {
+        SnapshotHeader h;
+        if (!header(data, len, h)) return false;
+        config.seed = h.seed;
+        config.world_width = h.world_width;
+        config.world_height = h.world_height;
+        config.bullet_capacity = h.bullet_capacity;
+        config.enemy_capacity = h.enemy_capacity;
+        config.boss_capacity = h.boss_capacity;
+        config.level_path.assign(h.level, strnlen(h.level, sizeof(h.level)));
+        return true;
+    }
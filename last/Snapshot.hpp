@@ -0,0 +1,107 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+struct GameConfig;
+
+struct SnapshotHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t bytes;                     // whole snapshot, header included
+    uint32_t seed;
+    int32_t world_width;
+    int32_t world_height;
+    int32_t bullet_capacity;
+    int32_t enemy_capacity;
+    int32_t boss_capacity;
+    int64_t ticks;
+    char level[120];                    // wave schedule path, empty for random spawns
+};
+
+// Appends plain values and arrays to a byte buffer. Arrays are written at a
+// fixed stride (their pool capacity) with the unused tail zeroed, so the
+// same field sits at the same offset from one tick to the next and deltas
+// against a keyframe stay small. Every record is padded to 4 bytes.
+class SnapshotWriter {
+    std::vector<uint8_t>& out;
+    uint8_t* grow(size_t n) {
+        size_t at = out.size();
+        out.resize(at + ((n + 3) & ~size_t(3)));
+        return out.data() + at;
+    }
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& out_) : out(out_) { out.clear(); }
+    template <typename T>
+    void put(const T& v) { memcpy(grow(sizeof(T)), &v, sizeof(T)); }
+    void put_bytes(const void* p, size_t n) { memcpy(grow(n), p, n); }
+    template <typename T>
+    void put_array(const std::vector<T>& v, size_t stride) {
+        uint8_t* p = grow(stride * sizeof(T));
+        memcpy(p, v.data(), v.size() * sizeof(T));
+        memset(p + v.size() * sizeof(T), 0, (stride - v.size()) * sizeof(T));
+    }
+    size_t size() const { return out.size(); }
+    uint8_t* at(size_t offset) { return out.data() + offset; }
+};
+
+// Reads back what SnapshotWriter produced, straight from memory (for
+// instance a mapped file). Any overrun clears ok() and leaves targets alone.
+class SnapshotReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool good;
+    const uint8_t* take(size_t n) {
+        n = (n + 3) & ~size_t(3);
+        if (!good || size_t(end - p) < n) {
+            good = false;
+            return nullptr;
+        }
+        const uint8_t* at = p;
+        p += n;
+        return at;
+    }
+public:
+    SnapshotReader(const uint8_t* data, size_t len) : p(data), end(data + len), good(true) {}
+    template <typename T>
+    void get(T& v) {
+        if (const uint8_t* at = take(sizeof(T))) memcpy(&v, at, sizeof(T));
+    }
+    void get_bytes(void* out, size_t n) {
+        if (const uint8_t* at = take(n)) memcpy(out, at, n);
+    }
+    // Fills v with count elements from an array written at the given stride.
+    template <typename T>
+    void get_array(std::vector<T>& v, size_t count, size_t stride) {
+        if (count > stride) good = false;
+        const uint8_t* at = take(stride * sizeof(T));
+        if (!at) return;
+        v.resize(count);
+        memcpy(v.data(), at, count * sizeof(T));
+    }
+    bool ok() const { return good; }
+    size_t remaining() const { return good ? size_t(end - p) : 0; }
+};
+
+// Flat, versioned dump of a whole Game, kept as a byte vector in memory and
+// saved to or loaded from disk through a memory mapping.
+class Snapshot {
+    const uint8_t* mapped;
+    size_t mapped_len;
+public:
+    static const uint16_t VERSION = 7;
+
+    Snapshot();
+    ~Snapshot();
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+    static bool save(const char* path, const std::vector<uint8_t>& state);
+    bool map(const char* path);
+    void unmap();
+    const uint8_t* data() const;
+    size_t size() const;
+    static bool header(const uint8_t* data, size_t len, SnapshotHeader& out);
+    static bool apply(const uint8_t* data, size_t len, GameConfig& config);
+};
@@ -0,0 +1,39 @@
+#include "SpatialGrid.hpp"
+#include <algorithm>
+
+    SpatialGrid::SpatialGrid(int w, int h, size_t capacity) : width(w), height(h), mask(63), growths(0) {
+        while (mask + 1 < capacity * 2) mask = mask * 2 + 1;
+        bucket_start.resize(mask + 2);
+        items.reserve(capacity);
+        item_cell.reserve(capacity);
+        pending_cell.reserve(capacity);
+        pending_id.reserve(capacity);
+    }
+    void SpatialGrid::clear() {
+        pending_cell.clear();
+        pending_id.clear();
+    }
+    void SpatialGrid::insert(int x, int y, int id) {
+        if (!contains(x, y)) return;
+        if (pending_id.size() == pending_id.capacity()) growths++;
+        pending_cell.push_back(uint32_t(y) * width + x);
+        pending_id.push_back(id);
+    }
+    void SpatialGrid::build() {
+        std::fill(bucket_start.begin(), bucket_start.end(), 0);
+        for (uint32_t cell : pending_cell) bucket_start[bucket(cell) + 1]++;
+        for (size_t i = 1; i < bucket_start.size(); i++) bucket_start[i] += bucket_start[i - 1];
+        items.resize(pending_id.size());
+        item_cell.resize(pending_id.size());
+        for (size_t i = 0; i < pending_id.size(); i++) {
+            int slot = bucket_start[bucket(pending_cell[i])]++;
+            items[slot] = pending_id[i];
+            item_cell[slot] = pending_cell[i];
+        }
+        for (size_t i = bucket_start.size() - 1; i > 0; i--) bucket_start[i] = bucket_start[i - 1];
+        bucket_start[0] = 0;
+    }
+    bool SpatialGrid::contains(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+    long SpatialGrid::allocations() const { return growths; }
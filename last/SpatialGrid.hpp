@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Bucketed cell hash over the arena. Entities are inserted by index, then
+// build() groups them by bucket with a stable counting sort, so each cell
+// yields its occupants in insertion order. Memory and rebuild cost scale
+// with the entity count, not with the arena size.
+class SpatialGrid {
+    int width, height;
+    uint32_t mask;
+    std::vector<int> bucket_start;
+    std::vector<int> items;
+    std::vector<uint32_t> item_cell;
+    std::vector<uint32_t> pending_cell;
+    std::vector<int> pending_id;
+    long growths;
+
+    uint32_t bucket(uint32_t cell) const { return (cell * 2654435761u) & mask; }
+public:
+    SpatialGrid(int w, int h, size_t capacity);
+    void clear();
+    void insert(int x, int y, int id);
+    void build();
+    bool contains(int x, int y) const;
+    template <typename F>
+    void for_each(int x, int y, F fn) const {
+        if (!contains(x, y)) return;
+        uint32_t cell = uint32_t(y) * width + x;
+        uint32_t b = bucket(cell);
+        for (int i = bucket_start[b]; i < bucket_start[b + 1]; i++)
+            if (item_cell[i] == cell) fn(items[i]);
+    }
+    long allocations() const;
+};
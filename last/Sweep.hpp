@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+
+// Swept overlap of two axis-aligned boxes that each move in a straight line
+// over one tick. Positions are fixed-point top-left corners before (0) and
+// after (1) the move; sizes use the same units. Interiors must overlap at
+// some t in [0, 1], so boxes that only touch, or only meet at t == 1, miss.
+// Times are compared as exact fractions, so the result does not depend on
+// speed and nothing can tunnel.
+struct SweptBox {
+    int x0, y0, x1, y1;
+    int w, h;
+};
+
+inline bool sweep_axis(int64_t r0, int64_t v, int64_t lo, int64_t hi,
+    int64_t& in_n, int64_t& in_d, int64_t& out_n, int64_t& out_d) {
+    if (v == 0) return lo < r0 && r0 < hi;
+    int64_t a_n = lo - r0, b_n = hi - r0, d = v;
+    if (d < 0) {
+        a_n = -a_n;
+        b_n = -b_n;
+        d = -d;
+    }
+    if (a_n > b_n) {
+        int64_t t = a_n;
+        a_n = b_n;
+        b_n = t;
+    }
+    if (a_n * in_d > in_n * d) {
+        in_n = a_n;
+        in_d = d;
+    }
+    if (b_n * out_d < out_n * d) {
+        out_n = b_n;
+        out_d = d;
+    }
+    return in_n * out_d < out_n * in_d;
+}
+
+// Overlap window clipped to the tick; in_n / in_d is when it starts.
+inline bool sweep_window(const SweptBox& a, const SweptBox& b, int64_t& in_n, int64_t& in_d) {
+    int64_t out_n = 1, out_d = 1;
+    in_n = 0;
+    in_d = 1;
+    return sweep_axis(int64_t(a.x0) - b.x0, int64_t(a.x1 - a.x0) - (b.x1 - b.x0), -a.w, b.w,
+            in_n, in_d, out_n, out_d)
+        && sweep_axis(int64_t(a.y0) - b.y0, int64_t(a.y1 - a.y0) - (b.y1 - b.y0), -a.h, b.h,
+            in_n, in_d, out_n, out_d);
+}
+
+inline bool swept_overlap(const SweptBox& a, const SweptBox& b) {
+    int64_t in_n, in_d;
+    return sweep_window(a, b, in_n, in_d);
+}
+
+// Only contacts that begin during this tick, so a body passing through
+// another over two ticks is reported once rather than on both. Boxes that
+// merely touch at t == 0 have not met yet: stepping in from the next cell
+// opens the window at exactly 0 and still counts.
+inline bool swept_enter(const SweptBox& a, const SweptBox& b) {
+    int64_t in_n, in_d;
+    if (!sweep_window(a, b, in_n, in_d)) return false;
+    const int64_t rx = int64_t(a.x0) - b.x0, ry = int64_t(a.y0) - b.y0;
+    return in_n > 0 || !(-a.w < rx && rx < b.w && -a.h < ry && ry < b.h);
+}
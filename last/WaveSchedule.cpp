@@ -0,0 +1,256 @@
+#include "WaveSchedule.hpp"
+#include "Snapshot.hpp"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct WaveSchedule::Line {
+    enum Type { BLANK, ENEMY, BOSS, FORMATION, WALL, END } type;
+    int64_t tick;
+    int shape;                          // formation: 0 column, 1 row, 2 vee
+    int count;
+    int lane;
+    int depth, width, height;           // walls
+    MovePattern move;
+    FirePattern fire;
+    const char* why;                    // set when decode() fails
+};
+
+struct Token {
+    const char* p;
+    size_t n;
+    bool is(const char* word) const { return n == strlen(word) && !memcmp(p, word, n); }
+};
+
+static bool number(const Token& t, long max, long& out) {
+    if (!t.n || t.n > 9) return false;
+    out = 0;
+    for (size_t i = 0; i < t.n; i++) {
+        if (t.p[i] < '0' || t.p[i] > '9') return false;
+        out = out * 10 + (t.p[i] - '0');
+    }
+    return out <= max;
+}
+
+static int pick(const Token& t, const char* const* names, int count) {
+    for (int i = 0; i < count; i++)
+        if (t.is(names[i])) return i;
+    return -1;
+}
+
+static const char* const move_names[MOVE_PATTERN_COUNT] = {"straight", "chase", "zigzag", "home"};
+static const char* const fire_names[FIRE_PATTERN_COUNT] = {"random", "none", "burst", "fan", "aimed"};
+static const char* const shape_names[3] = {"column", "row", "vee"};
+
+    WaveSchedule::WaveSchedule() : text(nullptr), text_len(0), next(0), fill_at(0), fill_base(0),
+        cursor(0), base(0) {
+        window.reserve(WINDOW);
+        error_[0] = '\0';
+    }
+    WaveSchedule::~WaveSchedule() { close(); }
+
+    // Maps the file and checks every line once, so a bad level is refused
+    // up front rather than halfway through a game.
+    bool WaveSchedule::open(const char* path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+            p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (fd >= 0) ::close(fd);
+        if (p == MAP_FAILED) {
+            snprintf(error_, sizeof(error_), "cannot read level");
+            return false;
+        }
+        text = static_cast<const char*>(p);
+        text_len = st.st_size;
+        int64_t last = 0;
+        int spawns = 0;
+        bool ended = false;
+        Line line;
+        for (size_t at = 0, n = 1; at < text_len; n++) {
+            if (decode(at, line)) {
+                if (line.type == Line::BLANK) continue;
+                if (ended) line.why = "end must be the last line";
+                else if (line.tick < last) line.why = "tick goes backwards";
+                else if (line.type == Line::END && (!spawns || line.tick == 0))
+                    line.why = "end needs spawns before it and a tick above 0";
+            }
+            if (line.why) {
+                snprintf(error_, sizeof(error_), "line %zu: %s", n, line.why);
+                close();
+                return false;
+            }
+            last = line.tick;
+            ended = line.type == Line::END;
+            spawns += !ended;
+        }
+        if (!spawns) {
+            snprintf(error_, sizeof(error_), "level has no spawns");
+            close();
+            return false;
+        }
+        fill(0, 0);
+        return true;
+    }
+    void WaveSchedule::close() {
+        if (text) munmap(const_cast<char*>(text), text_len);
+        text = nullptr;
+        text_len = 0;
+        window.clear();
+        next = fill_at = cursor = 0;
+        fill_base = base = 0;
+    }
+    bool WaveSchedule::loaded() const { return text != nullptr; }
+    const char* WaveSchedule::error() const { return error_; }
+    // Back to the first line, for a new game on the same level.
+    void WaveSchedule::restart() {
+        if (text) fill(0, 0);
+    }
+
+    // Reads the line starting at `at` and moves past it.
+    bool WaveSchedule::decode(size_t& at, Line& out) {
+        size_t end = at;
+        while (end < text_len && text[end] != '\n') end++;
+        const char* p = text + at;
+        const char* stop = text + end;
+        at = end < text_len ? end + 1 : end;
+        out = Line{Line::BLANK, 0, 0, 1, 0, 0, 1, 1, MOVE_STRAIGHT, FIRE_RANDOM, nullptr};
+        Token t[8];
+        int n = 0;
+        while (p < stop && *p != '#') {
+            if (*p == ' ' || *p == '\t' || *p == '\r') {
+                p++;
+                continue;
+            }
+            const char* word = p;
+            while (p < stop && *p != ' ' && *p != '\t' && *p != '\r' && *p != '#') p++;
+            if (n == 8) {
+                out.why = "too many fields";
+                return false;
+            }
+            t[n++] = Token{word, size_t(p - word)};
+        }
+        if (!n) return true;
+        long v;
+        if (!number(t[0], 999999999, v)) {
+            out.why = "expected a tick";
+            return false;
+        }
+        out.tick = v;
+        int rest = 2;
+        if (n == 2 && t[1].is("end")) {
+            out.type = Line::END;
+            return true;
+        } else if (n == 2 && t[1].is("boss")) {
+            out.type = Line::BOSS;
+            return true;
+        } else if (n == 6 && t[1].is("wall")) {
+            long f[4];
+            for (int i = 0; i < 4; i++)
+                if (!number(t[2 + i], 9999, f[i]) || (i >= 2 && f[i] < 1)) {
+                    out.why = "expected wall LANE DEPTH W H";
+                    return false;
+                }
+            out.type = Line::WALL;
+            out.lane = f[0];
+            out.depth = f[1];
+            out.width = f[2];
+            out.height = f[3];
+            return true;
+        } else if (n >= 3 && t[1].is("enemy")) {
+            out.type = Line::ENEMY;
+        } else if (n >= 5 && t[1].is("formation")) {
+            out.type = Line::FORMATION;
+            out.shape = pick(t[2], shape_names, 3);
+            if (out.shape < 0 || !number(t[3], MAX_FORMATION, v) || v < 1) {
+                out.why = "bad formation shape or count";
+                return false;
+            }
+            out.count = v;
+            rest = 4;
+        } else {
+            out.why = "expected enemy, formation, wall, boss or end";
+            return false;
+        }
+        int move = rest + 1 < n ? pick(t[rest + 1], move_names, MOVE_PATTERN_COUNT) : MOVE_STRAIGHT;
+        int fire = rest + 2 < n ? pick(t[rest + 2], fire_names, FIRE_PATTERN_COUNT) : FIRE_RANDOM;
+        if (!number(t[rest], 9999, v) || move < 0 || fire < 0 || n > rest + 3) {
+            out.why = "expected LANE [MOVE [FIRE]]";
+            return false;
+        }
+        out.lane = v;
+        out.move = MovePattern(move);
+        out.fire = FirePattern(fire);
+        return true;
+    }
+    void WaveSchedule::expand(const Line& line, int64_t pass) {
+        WaveEntry e{pass + line.tick, int16_t(line.lane), int16_t(line.depth), int16_t(line.width),
+            int16_t(line.height), line.type == Line::BOSS ? WAVE_BOSS : line.type == Line::WALL ? WAVE_WALL : WAVE_ENEMY,
+            line.move, line.fire};
+        if (line.type != Line::FORMATION) {
+            window.push_back(e);
+            return;
+        }
+        for (int k = 0; k < line.count; k++) {
+            int mid = line.count / 2;
+            int off = k - mid;
+            if (line.shape == 0) {
+                e.lane = line.lane + k;
+            } else if (line.shape == 1) {
+                e.depth = k * 2;
+            } else {
+                e.lane = line.lane + off;
+                e.depth = mid - abs(off);
+            }
+            if (e.lane >= 0) window.push_back(e);
+        }
+    }
+    // Compiles lines from offset `at` of the pass starting at tick `pass`
+    // until the window is full or the pass ends.
+    void WaveSchedule::fill(size_t at, int64_t pass) {
+        window.clear();
+        next = 0;
+        fill_at = at;
+        fill_base = pass;
+        Line line;
+        while (at < text_len && window.size() + MAX_FORMATION <= WINDOW) {
+            decode(at, line);
+            if (line.type == Line::END) {
+                at = 0;
+                pass += line.tick;
+                break;
+            }
+            if (line.type != Line::BLANK) expand(line, pass);
+        }
+        cursor = at;
+        base = pass;
+    }
+    void WaveSchedule::save(SnapshotWriter& w) const {
+        w.put(uint64_t(fill_at));
+        w.put(fill_base);
+        w.put(uint64_t(next));
+    }
+    bool WaveSchedule::load(SnapshotReader& r) {
+        uint64_t at = 0, taken = 0;
+        int64_t pass = 0;
+        r.get(at);
+        r.get(pass);
+        r.get(taken);
+        if (!r.ok() || at > text_len) return false;
+        const size_t was_at = fill_at, was_next = next;
+        const int64_t was_base = fill_base;
+        fill(at, pass);
+        if (taken > window.size()) {
+            fill(was_at, was_base);
+            next = was_next;
+            return false;
+        }
+        next = taken;
+        return true;
+    }
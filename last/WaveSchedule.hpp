@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Enemy.hpp"
+
+class SnapshotWriter;
+class SnapshotReader;
+
+enum WaveKind : unsigned char {
+    WAVE_ENEMY,
+    WAVE_BOSS,
+    WAVE_WALL
+};
+
+struct WaveEntry {
+    int64_t tick;                       // absolute game tick
+    int16_t lane;                       // row below the arena's top edge, wrapped to its height
+    int16_t depth;                      // columns left of the arena's right edge
+    int16_t width, height;              // walls only
+    WaveKind kind;
+    MovePattern move;
+    FirePattern fire;
+};
+
+// Scripted spawns from a level file, mapped read-only and checked once when
+// opened. Lines are `TICK enemy LANE [MOVE [FIRE]]`, `TICK boss`,
+// `TICK formation column|row|vee COUNT LANE [MOVE [FIRE]]`,
+// `TICK wall LANE DEPTH W H` (an obstacle, W x H cells) and `TICK end`,
+// which restarts the file TICK ticks after the previous start; `#` starts a
+// comment and ticks never decrease. The text is compiled into a fixed
+// window of flat entries, refilled from the mapping as the game reaches its
+// end, so a level of any length costs the same memory and each tick's spawn
+// step is an index bump.
+class WaveSchedule {
+public:
+    static const int WINDOW = 256;
+    static const int MAX_FORMATION = 32;
+
+private:
+    const char* text;
+    size_t text_len;
+    std::vector<WaveEntry> window;
+    size_t next;                        // next entry of window to spawn
+    size_t fill_at;                     // text offset the window was compiled from
+    int64_t fill_base;                  // tick of the pass fill_at belongs to
+    size_t cursor;                      // text offset after the window
+    int64_t base;                       // tick of the pass cursor belongs to
+    char error_[96];
+
+    struct Line;
+    bool decode(size_t& at, Line& out);
+    void expand(const Line& line, int64_t pass);
+    void fill(size_t at, int64_t pass);
+public:
+    WaveSchedule();
+    ~WaveSchedule();
+    WaveSchedule(const WaveSchedule&) = delete;
+    WaveSchedule& operator=(const WaveSchedule&) = delete;
+    bool open(const char* path);
+    void close();
+    bool loaded() const;
+    const char* error() const;
+    void restart();
+    template <typename F>
+    void take(int64_t tick, F&& spawn) {
+        while (true) {
+            if (next == window.size()) {
+                if (cursor == text_len) return;
+                fill(cursor, base);
+                continue;
+            }
+            if (window[next].tick > tick) return;
+            spawn(window[next++]);
+        }
+    }
+    void save(SnapshotWriter& w) const;
+    bool load(SnapshotReader& r);
+};
@@ -0,0 +1,37 @@
+#include "World.hpp"
+#include <algorithm>
+
+    World::World(int w, int h) : width(w), height(h),
+        chunks_x((w + CHUNK - 1) / CHUNK), chunks_y((h + CHUNK - 1) / CHUNK),
+        active{0, 0, w, h}, chunk_steps(chunks_x * chunks_y, 1), uniform(true), wall_version(0) {
+        walls.reserve(MAX_WALLS);
+    }
+    bool World::contains(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+    // Clipped to the world; repeats of an existing wall are ignored so a
+    // looping level does not pile them up.
+    bool World::add_wall(const Rect& r) {
+        Rect c{std::max(r.x0, 0), std::max(r.y0, 0), std::min(r.x1, width), std::min(r.y1, height)};
+        if (c.x0 >= c.x1 || c.y0 >= c.y1 || walls.size() >= size_t(MAX_WALLS)) return false;
+        for (const Rect& w : walls)
+            if (w.x0 == c.x0 && w.y0 == c.y0 && w.x1 == c.x1 && w.y1 == c.y1) return false;
+        walls.push_back(c);
+        wall_version++;
+        return true;
+    }
+    void World::set_walls(const std::vector<Rect>& r) {
+        walls.assign(r.begin(), r.end());
+        wall_version++;
+    }
+    void World::plan(const Rect& active_, long tick) {
+        active = active_;
+        int cx0 = active.x0 / CHUNK, cx1 = (active.x1 - 1) / CHUNK;
+        int cy0 = active.y0 / CHUNK, cy1 = (active.y1 - 1) / CHUNK;
+        uniform = cx0 == 0 && cy0 == 0 && cx1 == chunks_x - 1 && cy1 == chunks_y - 1;
+        for (int cy = 0; cy < chunks_y; cy++)
+            for (int cx = 0; cx < chunks_x; cx++) {
+                unsigned char steps = 1;
+                if (cx < cx0 || cx > cx1 || cy < cy0 || cy > cy1)
+                    steps = (cx + cy) % FAR_TICK_DIVISOR == tick % FAR_TICK_DIVISOR ? FAR_TICK_DIVISOR : 0;
+                chunk_steps[cy * chunks_x + cx] = steps;
+            }
+    }
@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+
+struct Rect {
+    int x0, y0, x1, y1;                 // half-open: [x0, x1) x [y0, y1)
+    int width() const { return x1 - x0; }
+    int height() const { return y1 - y0; }
+    bool contains(int x, int y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+};
+
+// Runtime-sized arena split into square chunks. Chunks overlapping the
+// active region around the player step every tick; the rest step in
+// FAR_TICK_DIVISOR-tick strides, staggered so each tick touches a quarter
+// of them.
+class World {
+public:
+    int width, height;
+    int chunks_x, chunks_y;
+    Rect active;
+    std::vector<unsigned char> chunk_steps;
+    bool uniform;                       // every chunk steps once this tick
+    std::vector<Rect> walls;            // obstacle cells, for pathing
+    long wall_version;                  // bumped whenever walls change
+
+    World(int w, int h);
+    bool contains(int x, int y) const;
+    bool add_wall(const Rect& r);
+    void set_walls(const std::vector<Rect>& r);
+    void plan(const Rect& active_, long tick);
+    int steps_at(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return 1;
+        return chunk_steps[(y / CHUNK) * chunks_x + x / CHUNK];
+    }
+
+    static const int CHUNK = 32;
+    static const int FAR_TICK_DIVISOR = 4;
+    static const int MAX_WALLS = 32;
+};
@@ -0,0 +1,415 @@
+#include "Game.hpp"
+#include "BatchEnv.hpp"
+#include "Boss.hpp"
+#include "NullRenderer.hpp"
+#include "Emitter.hpp"
+#include "Constants.hpp"
+#include "AllocStats.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <vector>
+
+// Headless stress benchmark for the simulation core. Each scenario keeps the
+// arena topped up to a fixed population and reports one JSON object per line.
+
+// A build with SHMUP_ALLOC_STATS already replaces the global allocator, so
+// the bench reads its counters instead of installing its own.
+#ifdef SHMUP_ALLOC_STATS
+static long allocation_count() { return AllocStats::allocations(); }
+#else
+static long g_allocations = 0;
+
+void* operator new(size_t size) {
+    g_allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static long allocation_count() { return g_allocations; }
+#endif
+
+struct Scenario {
+    const char* name;
+    int bullets;
+    int enemies;
+    int bosses;
+    int world_width;
+    int world_height;
+    bool homing;                        // enemies follow the flow field around a few walls
+    bool patterned;                     // enemy bullets in every direction, as the emitters fire them
+    bool rewind;                        // keeps the rewind ring, so every tick also takes a snapshot
+};
+
+static const Scenario scenarios[] = {
+    {"idle", 0, 0, 0, WIDTH, HEIGHT, false, false, false},
+    {"bullets_10k", 10000, 0, 0, WIDTH, HEIGHT, false, false, false},
+    {"enemies_2k", 0, 2000, 0, WIDTH, HEIGHT, false, false, false},
+    {"bosses_8", 0, 0, 8, WIDTH, HEIGHT, false, false, false},
+    {"boss_fight", 5000, 500, 16, WIDTH, HEIGHT, false, false, false},
+    {"mixed", 10000, 2000, 4, WIDTH, HEIGHT, false, false, false},
+    {"mixed_rewind", 10000, 2000, 4, WIDTH, HEIGHT, false, false, true},
+    {"world_2000x1000", 20000, 5000, 4, 2000, 1000, false, false, false},
+    {"homing_100", 0, 100, 0, WIDTH, HEIGHT, true, false, false},
+    {"homing_1k", 0, 1000, 0, WIDTH, HEIGHT, true, false, false},
+    {"homing_4k", 0, 4000, 0, WIDTH, HEIGHT, true, false, false},
+    {"homing_16k", 0, 16000, 0, WIDTH, HEIGHT, true, false, false},
+    {"bullet_hell_50k", 50000, 0, 1, WIDTH, HEIGHT, false, true, false},
+};
+
+struct Series {
+    std::vector<long> samples;
+    void reserve(long n) { samples.reserve(n); }
+    void add(long ns) { samples.push_back(ns); }
+    double total() const {
+        double sum = 0;
+        for (long s : samples) sum += s;
+        return sum;
+    }
+    void report(const char* name, bool last) {
+        std::sort(samples.begin(), samples.end());
+        double mean = 0;
+        for (long s : samples) mean += s;
+        if (!samples.empty()) mean /= samples.size();
+        long p50 = samples.empty() ? 0 : samples[samples.size() / 2];
+        long p99 = samples.empty() ? 0 : samples[samples.size() * 99 / 100];
+        long max = samples.empty() ? 0 : samples.back();
+        printf("\"%s\":{\"mean_ns\":%.1f,\"p50_ns\":%ld,\"p99_ns\":%ld,\"max_ns\":%ld}%s",
+            name, mean, p50, p99, max, last ? "" : ",");
+    }
+};
+
+static void top_up(Game& game, const Scenario& sc, std::mt19937& rng) {
+    const int w = sc.world_width, h = sc.world_height;
+    while ((int)game.bullets.size() < sc.bullets) {
+        int x = rng() % w, y = rng() % (h - 1) + 1;
+        if (sc.patterned) Emitter::shoot(game.bullets, x, y, rng() % Emitter::DIRECTIONS, FIX_ONE / 4 + rng() % FIX_ONE);
+        else Bullet::spawn(game.bullets, x, y, rng() & 1);
+    }
+    while ((int)game.enemies.size() < sc.enemies) {
+        int x = w - 1 - rng() % (w / 2), y = rng() % (h - 2) + 1;
+        if (sc.homing) Enemy::spawn(game.enemies, x, y, MOVE_HOME, FIRE_NONE);
+        else Enemy::spawn(game.enemies, x, y, rng() & 1);
+    }
+    while ((int)game.bosses.size() < sc.bosses)
+        Boss::spawn(game.bosses, w / 2 + rng() % (w / 2 - 1), rng() % (h - Boss::height) + 1);
+}
+
+static void run(const Scenario& sc, long ticks, unsigned seed, int threads) {
+    GameConfig config;
+    config.seed = seed;
+    config.threads = threads;
+    config.time_phases = true;
+    config.bullet_capacity = std::max(BULLET_CAPACITY, sc.bullets * 2);
+    config.enemy_capacity = std::max(ENEMY_CAPACITY, sc.enemies * 2);
+    config.boss_capacity = std::max(BOSS_CAPACITY, sc.bosses);
+    config.world_width = sc.world_width;
+    config.world_height = sc.world_height;
+    config.rewind_seconds = sc.rewind ? REWIND_SECONDS : 0;
+    NullRenderer renderer(std::vector<int>{' ', KEY_NONE, 'w', ' ', 's', KEY_NONE});
+    Game game(renderer, config);
+    if (sc.homing)
+        for (int i = 0; i < 4; i++) game.world.add_wall(Rect{20 + i * 14, 3 + i % 2 * 9, 22 + i * 14, 12 + i % 2 * 9});
+    std::mt19937 rng(seed);
+    Series input, update, flow, collide, render, snapshot, total;
+    input.reserve(ticks);
+    update.reserve(ticks);
+    flow.reserve(ticks);
+    collide.reserve(ticks);
+    render.reserve(ticks);
+    snapshot.reserve(ticks);
+    total.reserve(ticks);
+
+    long allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long t = 0; t < ticks; t++) {
+        top_up(game, sc, rng);
+        game.game_over = false;
+        long before = allocation_count();
+        game.step(renderer.read_key());
+        allocations += allocation_count() - before;
+        const PhaseTimes& p = game.phase_times();
+        input.add(p.input_ns);
+        update.add(p.update_ns);
+        flow.add(p.flow_ns);
+        collide.add(p.collide_ns);
+        render.add(p.render_ns);
+        snapshot.add(p.snapshot_ns);
+        total.add(p.input_ns + p.update_ns + p.collide_ns + p.render_ns + p.snapshot_ns);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Full save and load of the final state, averaged over a few rounds.
+    const int rounds = 64;
+    std::vector<uint8_t> state;
+    game.save_state(state);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) game.save_state(state);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) game.load_state(state.data(), state.size());
+    auto t2 = std::chrono::steady_clock::now();
+    double save_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / rounds;
+    double load_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / rounds;
+
+    printf("{\"scenario\":\"%s\",\"ticks\":%ld,\"seed\":%u,\"threads\":%d,\"bullets\":%d,\"enemies\":%d,\"bosses\":%d,\"world\":\"%dx%d\",",
+        sc.name, ticks, seed, game.jobs.thread_count(), sc.bullets, sc.enemies, sc.bosses, sc.world_width, sc.world_height);
+    printf("\"state_hash\":\"%016llx\",", (unsigned long long)game.state_hash());
+    printf("\"ticks_per_sec\":%.1f,\"allocs_per_tick\":%.4f,\"steals\":%ld,", ticks / seconds,
+        (double)allocations / ticks, game.jobs.steals());
+    // Rebuild cost next to what it serves: the field is one BFS however many
+    // enemies read it, so the per-enemy share falls as the swarm grows.
+    const long builds = game.field.build_count();
+    printf("\"field_builds\":%ld,\"field_ns_per_build\":%.0f,\"field_ns_per_enemy_tick\":%.2f,\"events\":{", builds,
+        builds ? flow.total() / builds : 0.0, sc.enemies ? flow.total() / ticks / sc.enemies : 0.0);
+    for (int e = 0; e < EVENT_COUNT; e++)
+        printf("%s\"%s\":%ld", e ? "," : "", EventBus::name(GameEventType(e)), game.loop_stats().events[e]);
+    printf("},");
+    printf("\"snapshot_bytes\":%zu,\"save_ns\":%.0f,\"load_ns\":%.0f,\"rewind_bytes\":%ld,",
+        state.size(), save_ns, load_ns, game.loop_stats().rewind_bytes);
+    input.report("handle_input", false);
+    update.report("update", false);
+    flow.report("flow_field", false);
+    collide.report("check_collisions", false);
+    render.report("render", false);
+    snapshot.report("snapshot", false);
+    total.report("tick", true);
+    printf("}\n");
+    fflush(stdout);
+}
+
+// Lockstep batch of independent games, each fed a shifted copy of a bot key
+// script; reports total game ticks per second across the batch.
+static void run_batch(size_t count, long steps, unsigned seed, int threads) {
+    static const int script[] = {' ', KEY_NONE, 'w', KEY_NONE, ' ', 's', 's', KEY_NONE, 'd', ' ', 'a', 'w'};
+    const size_t period = sizeof(script) / sizeof(script[0]);
+    GameConfig config;
+    config.seed = seed;
+    config.max_ticks = 2000;
+    auto built = std::chrono::steady_clock::now();
+    BatchEnv batch(count, config, threads);
+    double build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - built).count();
+    std::vector<int> keys(count);
+    long allocations = 0;
+    uint64_t hash = 14695981039346656037ULL;
+    auto start = std::chrono::steady_clock::now();
+    for (long t = 0; t < steps; t++) {
+        for (size_t i = 0; i < count; i++) keys[i] = script[(t + i) % period];
+        long before = allocation_count();
+        const BatchObservation& obs = batch.step(keys.data());
+        allocations += allocation_count() - before;
+        for (size_t i = 0; i < count; i++)
+            if (obs.done[i]) hash = (hash ^ uint32_t(obs.score[i] * 131 + obs.ticks[i])) * 1099511628211ULL;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("{\"batch\":%zu,\"steps\":%ld,\"seed\":%u,\"threads\":%d,\"game_ticks\":%ld,", count, steps, seed,
+        threads, batch.game_ticks());
+    printf("\"game_ticks_per_sec\":%.0f,\"steps_per_sec\":%.1f,\"allocs_per_step\":%.4f,",
+        batch.game_ticks() / seconds, steps / seconds, (double)allocations / steps);
+    printf("\"episodes\":%ld,\"episode_hash\":\"%016llx\",\"steals\":%ld,\"build_ms\":%.1f,\"game_bytes\":%zu}\n",
+        batch.episodes_finished(), (unsigned long long)hash, batch.steals(), build_ms, sizeof(Game));
+    fflush(stdout);
+}
+
+// Times every bullet kernel the CPU supports on the same random bullets and
+// checks that each one leaves exactly the bytes the scalar kernel does.
+static bool run_kernels(long count, long rounds, unsigned seed) {
+    const World world(WIDTH, HEIGHT);
+    std::mt19937 rng(seed);
+    EntityStore base(count, POOL_DROP);
+    const int px = WIDTH / 8, py = HEIGHT / 2;
+    for (long i = 0; i < count; i++) {
+        // A quarter start around the player so the screen has hits to find.
+        int x = rng() % (WIDTH + 4) - 2, y = rng() % (HEIGHT + 4) - 2;
+        if (i % 4 == 0) {
+            x = px + int(rng() % 7) - 3;
+            y = py + int(rng() % 7) - 3;
+        }
+        int vx = int(rng() % (4 * FIX_ONE)) - 2 * FIX_ONE, vy = int(rng() % (2 * FIX_ONE)) - FIX_ONE;
+        if (rng() % 8) Bullet::launch(base, x, y, vx, vy);
+        else Bullet::spawn(base, x, y, true, vx);
+        if (rng() % 10 == 0) base.kill(i);
+    }
+    EntityStore expect = base;
+    std::vector<unsigned char> expect_near(count);
+    bool all = true;
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        BulletKernel kernel = BulletKernel(k);
+        if (!Bullet::supported(kernel)) continue;
+        EntityStore s = base;
+        expect = base;
+        std::vector<unsigned char> near(count);
+        bool match = true;
+        long advance_ns = 0, screen_ns = 0;
+        for (long r = 0; r < rounds; r++) {
+            auto t0 = std::chrono::steady_clock::now();
+            Bullet::update(s, world, 0, count, kernel);
+            auto t1 = std::chrono::steady_clock::now();
+            Bullet::threats(s, px, py, 0, count, near.data(), kernel);
+            auto t2 = std::chrono::steady_clock::now();
+            advance_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+            screen_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+            if (kernel == KERNEL_SCALAR) continue;
+            Bullet::update(expect, world, 0, count, KERNEL_SCALAR);
+            Bullet::threats(expect, px, py, 0, count, expect_near.data(), KERNEL_SCALAR);
+            match = s.x == expect.x && s.y == expect.y && s.fx == expect.fx && s.fy == expect.fy
+                && s.ox == expect.ox && s.oy == expect.oy && s.alive == expect.alive && near == expect_near;
+            if (!match) break;
+        }
+        long threats = 0;
+        for (unsigned char n : near) threats += n;
+        printf("{\"kernel\":\"%s\",\"bullets\":%ld,\"rounds\":%ld,\"advance_ns_per_bullet\":%.3f,"
+            "\"screen_ns_per_bullet\":%.3f,\"near_player\":%ld,\"matches_scalar\":%s}\n",
+            Bullet::kernel_name(kernel), count, rounds, (double)advance_ns / rounds / count,
+            (double)screen_ns / rounds / count, threats, match ? "true" : "false");
+        all = all && match;
+        fflush(stdout);
+    }
+    return all;
+}
+
+// Handles and the recycling order of a full pool. Each entity's x is its
+// spawn number, so a handle can be checked against the entity it finds.
+static bool pool_finds(const EntityStore& s, EntityHandle h, int id) {
+    long i = s.index_of(h);
+    return i >= 0 && s.x[i] == id;
+}
+
+static bool run_pools(long count, long rounds) {
+    EntityStore s(count, POOL_RECYCLE_OLDEST);
+    std::vector<EntityHandle> handles;
+    int id = 0;
+    for (long i = 0; i < count; i++) handles.push_back(s.spawn(id++, 0, 0, 0, KIND_ENEMY_BULLET));
+    bool ok = s.size() == size_t(count);
+    // Every third dies; compaction moves the rest, and their handles follow.
+    for (long i = 0; i < count; i += 3) s.kill(s.index_of(handles[i]));
+    s.compact();
+    for (long i = 0; i < count; i++) ok = ok && (i % 3 ? pool_finds(s, handles[i], int(i)) : s.index_of(handles[i]) < 0);
+    // Refilling takes the freed slots, and the stale handles stay stale.
+    while (s.size() < size_t(count)) handles.push_back(s.spawn(id++, 0, 0, 0, KIND_ENEMY_BULLET));
+    for (long i = 0; i < count; i += 3) ok = ok && s.index_of(handles[i]) < 0;
+    ok = ok && s.recycled_spawns() == 0;
+    // A full pool overwrites the dead before the oldest live entity...
+    const EntityHandle newest = handles.back();
+    s.kill(s.index_of(newest));
+    EntityHandle h = s.spawn(id, 0, 0, 0, KIND_ENEMY_BULLET);
+    ok = ok && pool_finds(s, h, id++) && s.index_of(newest) < 0 && pool_finds(s, handles[1], 1);
+    handles.push_back(h);
+    // ...then the oldest, in spawn order, also after a snapshot round trip.
+    std::vector<uint8_t> blob;
+    SnapshotWriter out(blob);
+    s.save(out);
+    EntityStore copy(1, POOL_RECYCLE_OLDEST);
+    SnapshotReader in(blob.data(), blob.size());
+    ok = ok && copy.load(in);
+    for (EntityStore* store : {&s, &copy}) {
+        int next = id;
+        store->spawn(next++, 0, 0, 0, KIND_ENEMY_BULLET);
+        ok = ok && store->index_of(handles[1]) < 0 && pool_finds(*store, handles[2], 2);
+        store->spawn(next++, 0, 0, 0, KIND_ENEMY_BULLET);
+        ok = ok && store->index_of(handles[2]) < 0 && pool_finds(*store, handles[4], 4);
+        ok = ok && store->x == s.x;
+    }
+    id += 2;
+    auto t0 = std::chrono::steady_clock::now();
+    for (long r = 0; r < rounds; r++)
+        for (long i = 0; i < count; i++) s.spawn(id++, 0, 0, 0, KIND_ENEMY_BULLET);
+    auto t1 = std::chrono::steady_clock::now();
+    long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    ok = ok && s.size() == size_t(count) && s.allocations() == 0;
+    printf("{\"pool\":\"recycle_oldest\",\"capacity\":%ld,\"rounds\":%ld,\"recycle_ns_per_spawn\":%.3f,"
+        "\"recycled\":%ld,\"handles_ok\":%s}\n", count, rounds, rounds ? (double)ns / rounds / count : 0.0,
+        s.recycled_spawns(), ok ? "true" : "false");
+    fflush(stdout);
+    return ok;
+}
+
+// A homing enemy that ends a tick on the player's cell must have cost a life
+// that tick, whether it walked in or the player walked onto it while it
+// stood still. Everything else is cleared every tick, so only it can hit.
+static bool run_contacts(long rounds, unsigned seed) {
+    long reached = 0, missed = 0, walked_in = 0;
+    for (long r = 0; r < rounds; r++) {
+        const bool walking = r % 2;
+        GameConfig config;
+        config.seed = seed + r;
+        NullRenderer renderer;
+        Game game(renderer, config);
+        const int px = game.player.get_x(), py = game.player.get_y();
+        EntityHandle h = Enemy::spawn(game.enemies, px + 4 + r % 9, std::max(1, py - 4 + int(r % 9)), MOVE_HOME, FIRE_NONE);
+        bool inside = false;
+        for (int t = 0; t < 400; t++) {
+            const long self = game.enemies.index_of(h);
+            if (self < 0) break;
+            for (size_t i = 0; i < game.enemies.size(); i++)
+                if (long(i) != self) game.enemies.kill(i);
+            game.enemies.compact();
+            game.bullets.clear();
+            game.bosses.clear();
+            const int lives = game.player.get_lives(), ex = game.enemies.x[self];
+            game.step(walking && game.player.get_x() < ex ? 'd' : KEY_NONE);
+            const long i = game.enemies.index_of(h);
+            const bool on = i >= 0 && game.enemies.x[i] == game.player.get_x() && game.enemies.y[i] == game.player.get_y();
+            if (on && !inside) {
+                reached++;
+                if (game.player.get_lives() == lives) missed++;
+                else if (walking && game.player.get_x() != px) walked_in++;
+                break;
+            }
+            inside = on;
+        }
+    }
+    bool ok = reached == rounds && missed == 0;
+    printf("{\"contacts\":%ld,\"reached\":%ld,\"missed\":%ld,\"player_walked_in\":%ld,\"ok\":%s}\n", rounds,
+        reached, missed, walked_in, ok ? "true" : "false");
+    fflush(stdout);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    long ticks = 20000;
+    unsigned seed = 1;
+    const char* only = nullptr;
+    int threads = 1;
+    long batch = 0;
+    long kernels = 0;
+    long pools = 0;
+    long contacts = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--batch") && i + 1 < argc) batch = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--kernels") && i + 1 < argc) kernels = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--pools") && i + 1 < argc) pools = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--contacts") && i + 1 < argc) contacts = strtol(argv[++i], nullptr, 10);
+        else {
+            fprintf(stderr, "usage: %s [--ticks N] [--seed N] [--threads N] [--scenario NAME | --batch GAMES | --kernels BULLETS | --pools SLOTS | --contacts ROUNDS]\n", argv[0]);
+            return 1;
+        }
+    }
+    int status = 0;
+    if (kernels > 0) {
+        status = run_kernels(kernels, ticks, seed) ? 0 : 1;
+    } else if (pools > 0) {
+        status = run_pools(pools, ticks) ? 0 : 1;
+    } else if (contacts > 0) {
+        status = run_contacts(contacts, seed) ? 0 : 1;
+    } else if (batch > 0) {
+        run_batch(batch, ticks, seed, threads);
+    } else {
+        for (const Scenario& sc : scenarios)
+            if (!only || !strcmp(only, sc.name)) run(sc, ticks, seed, threads);
+    }
+#ifdef SHMUP_ALLOC_STATS
+    fflush(stdout);
+    AllocStats::report(stderr);
+#endif
+    return status;
+}
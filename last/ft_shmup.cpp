@@ -1,7 +1,232 @@
 #include "Game.hpp"
+#include "NcursesRenderer.hpp"
+#include "AnsiRenderer.hpp"
+#include "NullRenderer.hpp"
+#include "Recording.hpp"
+#include "Snapshot.hpp"
+#include "Constants.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <memory>
 
-int main() {
-    Game game;
-    game.run();
+static void usage(const char* name) {
+    fprintf(stderr, "usage: %s [--seed N] [--threads N] [--world WxH] [--level FILE] [--renderer ncurses|ansi] [--headless TICKS] [--keys SCRIPT] [--record FILE]\n"
+        "          [--rewind SECONDS] [--save-state FILE] [--load-state FILE] [--profile FILE]\n"
+        "          [--alloc-strict TICK]\n"
+        "       %s --replay FILE... [--from TICK [--renderer ncurses|ansi]]\n"
+        "  --threads N       worker threads for the update and collision sweeps\n"
+        "  --world WxH       arena size in cells, at least %dx%d; the terminal scrolls over it\n"
+        "  --level FILE      spawn the waves scripted in FILE instead of random ones\n"
+        "  --renderer NAME   terminal backend: ncurses (default) or ansi, raw escape codes\n"
+        "                    with one write() per frame; output totals go to stderr\n"
+        "  --headless TICKS  run without a terminal for TICKS ticks (0 = until game over)\n"
+        "  --keys SCRIPT     headless input, one character per tick, '.' for no key\n"
+        "  --record FILE     save the session's seed and input log to FILE\n"
+        "  --rewind SECONDS  keep this much history for the 'r' key (0 = off)\n"
+        "  --save-state FILE write the final game state to FILE\n"
+        "  --load-state FILE start from a state saved with --save-state\n"
+        "  --profile FILE    dump per-frame timings as Chrome trace JSON, or CSV for *.csv\n"
+        "                    (needs make profile; 'p' toggles the timing overlay)\n"
+        "  --alloc-strict TICK fail the run if the game loop allocates from TICK on\n"
+        "                    (needs make allocstats, which reports allocations at exit)\n"
+        "  --replay FILE     re-simulate a recording headless and check its final hash\n"
+        "  --from TICK       fast-forward a replay to TICK, then watch it live\n", name, name, WIDTH, HEIGHT);
+}
+
+// Checked before any renderer starts, so the message lands on a sane terminal.
+static bool level_ok(const GameConfig& config) {
+    WaveSchedule level;
+    if (config.level_path.empty() || level.open(config.level_path.c_str())) return true;
+    fprintf(stderr, "%s: %s\n", config.level_path.c_str(), level.error());
+    return false;
+}
+
+static int verify(const char* path, int threads) {
+    Recording log;
+    if (!log.load(path)) {
+        fprintf(stderr, "%s: cannot read recording\n", path);
+        return 1;
+    }
+    GameConfig config;
+    log.apply(config);
+    if (!level_ok(config)) return 1;
+    config.threads = threads;
+    NullRenderer renderer;
+    Game game(renderer, config);
+    game.replay_from(log);
+    auto start = std::chrono::steady_clock::now();
+    game.fast_forward(log.ticks());
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    bool ok = game.ticks == log.ticks() && game.state_hash() == log.final_hash();
+    printf("%s: %s ticks=%ld score=%d lives=%d log=%zuB %.2fms\n", path, ok ? "OK" : "MISMATCH",
+        game.ticks, game.score, game.player.get_lives(), log.stream_bytes(), ms);
+    return ok ? 0 : 1;
+}
+
+static Renderer* terminal(bool ansi) {
+    if (ansi) return new AnsiRenderer;
+    return new NcursesRenderer;
+}
+
+static void report_output(bool ansi, const OutputStats& out, long frames) {
+    fprintf(stderr, "%s: %ld bytes in %ld writes over %ld frames (%.1f B/frame, %.2f writes/frame)\n",
+        ansi ? "ansi" : "ncurses", out.bytes, out.writes, frames,
+        frames ? double(out.bytes) / frames : 0.0, frames ? double(out.writes) / frames : 0.0);
+}
+
+static int watch(const char* path, long from, bool ansi) {
+    Recording log;
+    if (!log.load(path)) {
+        fprintf(stderr, "%s: cannot read recording\n", path);
+        return 1;
+    }
+    GameConfig config;
+    log.apply(config);
+    if (!level_ok(config)) return 1;
+    OutputStats out;
+    long frames = 0;
+    {
+        std::unique_ptr<Renderer> renderer(terminal(ansi));
+        Game game(*renderer, config);
+        game.replay_from(log);
+        game.fast_forward(from);
+        game.run();
+        out = renderer->output();
+        frames = game.loop_stats().rendered;
+    }
+    report_output(ansi, out, frames);
+    return 0;
+}
+
+static int start(Game& game, const Snapshot& state, const char* path, const char* profile_path) {
+    if (state.data() && !game.load_state(state.data(), state.size())) {
+        fprintf(stderr, "%s: snapshot does not match this game\n", path);
+        return 1;
+    }
+    if (profile_path && !game.profile_to(profile_path)) {
+        fprintf(stderr, "%s: cannot write profile (is this a make profile build?)\n", profile_path);
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv) {
+    GameConfig config;
+    config.seed = time(nullptr);
+    config.rewind_seconds = REWIND_SECONDS;
+    const char* save_path = nullptr;
+    const char* load_path = nullptr;
+    const char* profile_path = nullptr;
+    bool headless = false;
+    bool ansi = false;
+    std::vector<int> script;
+    const char* record_path = nullptr;
+    std::vector<const char*> replays;
+    long from = -1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            config.seed = strtoul(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            config.threads = strtol(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--world") && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &config.world_width, &config.world_height) != 2
+                || config.world_width < WIDTH || config.world_height < HEIGHT) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--level") && i + 1 < argc) {
+            config.level_path = argv[++i];
+        } else if (!strcmp(argv[i], "--renderer") && i + 1 < argc) {
+            ansi = !strcmp(argv[++i], "ansi");
+            if (!ansi && strcmp(argv[i], "ncurses")) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--headless") && i + 1 < argc) {
+            headless = true;
+            config.max_ticks = strtol(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--keys") && i + 1 < argc) {
+            for (const char* k = argv[++i]; *k; k++) script.push_back(*k == '.' ? KEY_NONE : *k);
+        } else if (!strcmp(argv[i], "--record") && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (!strcmp(argv[i], "--rewind") && i + 1 < argc) {
+            config.rewind_seconds = strtol(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--save-state") && i + 1 < argc) {
+            save_path = argv[++i];
+        } else if (!strcmp(argv[i], "--load-state") && i + 1 < argc) {
+            load_path = argv[++i];
+        } else if (!strcmp(argv[i], "--profile") && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (!strcmp(argv[i], "--alloc-strict") && i + 1 < argc) {
+#ifdef SHMUP_ALLOC_STATS
+            AllocStats::strict(strtol(argv[++i], nullptr, 10));
+#else
+            fprintf(stderr, "--alloc-strict needs make allocstats\n");
+            return 1;
+#endif
+        } else if (!strcmp(argv[i], "--replay") && i + 1 < argc) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2)) replays.push_back(argv[++i]);
+        } else if (!strcmp(argv[i], "--from") && i + 1 < argc) {
+            from = strtol(argv[++i], nullptr, 10);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!replays.empty()) {
+        if (from >= 0) return watch(replays[0], from, ansi);
+        int failed = 0;
+        for (const char* path : replays) failed += verify(path, config.threads);
+        return failed ? 1 : 0;
+    }
+    Snapshot state;
+    if (load_path && (!state.map(load_path) || !Snapshot::apply(state.data(), state.size(), config))) {
+        fprintf(stderr, "%s: cannot read snapshot\n", load_path);
+        return 1;
+    }
+    if (!level_ok(config)) return 1;
+    Recording log;
+    std::vector<uint8_t> final_state;
+    int status = 0;
+    if (headless) {
+        NullRenderer renderer(script);
+        Game game(renderer, config);
+        if (start(game, state, load_path, profile_path)) return 1;
+        if (record_path) game.record_to(log);
+        game.run();
+        printf("seed=%u ticks=%ld score=%d lives=%d\n", config.seed, game.ticks, game.score, game.player.get_lives());
+        if (save_path) game.save_state(final_state);
+    } else {
+        OutputStats out;
+        long frames = 0;
+        {
+            std::unique_ptr<Renderer> renderer(terminal(ansi));
+            Game game(*renderer, config);
+            if (start(game, state, load_path, profile_path)) return 1;
+            if (record_path) game.record_to(log);
+            game.run();
+            if (save_path) game.save_state(final_state);
+            out = renderer->output();
+            frames = game.loop_stats().rendered;
+        }
+        report_output(ansi, out, frames);
+    }
+    if (save_path && !Snapshot::save(save_path, final_state)) {
+        fprintf(stderr, "%s: cannot write snapshot\n", save_path);
+        status = 1;
+    }
+    if (record_path && !log.save(record_path)) {
+        fprintf(stderr, "%s: cannot write recording\n", record_path);
+        status = 1;
+    }
+#ifdef SHMUP_ALLOC_STATS
+    fflush(stdout);
+    AllocStats::report(stderr);
+    if (AllocStats::failed()) status = 1;
+#endif
+    return status;
+}